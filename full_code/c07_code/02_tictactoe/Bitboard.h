@@ -0,0 +1,330 @@
+#pragma once
+
+#include <array>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+
+// Board of WIDTH x HEIGHT cells with one bit per cell; cell (x, y) is
+// bit x + y * WIDTH. Set operations on whole boards, such as "cells
+// occupied by either player" or "cells of this line that are still
+// empty", are bitwise operations on a few 64-bit words, and count() is a
+// population count.
+template <size_t WIDTH, size_t HEIGHT>
+class Bitboard
+{
+	static_assert(WIDTH > 0 && HEIGHT > 0, "A Bitboard needs at least one cell.");
+
+public:
+	static const size_t kNumCells = WIDTH * HEIGHT;
+
+	// Returns a board with all cells set.
+	static Bitboard full();
+
+	// Throw out_of_range for invalid coordinates.
+	bool test(size_t x, size_t y) const;
+	void set(size_t x, size_t y);
+	void reset(size_t x, size_t y);
+
+	// Returns the number of set cells.
+	size_t count() const;
+	bool any() const;
+	bool none() const { return !any(); }
+
+	// Calls func(x, y) for every set cell, row by row.
+	template <typename Func>
+	void forEachSet(Func func) const;
+
+	Bitboard& operator&=(const Bitboard& rhs);
+	Bitboard& operator|=(const Bitboard& rhs);
+	Bitboard& operator^=(const Bitboard& rhs);
+	Bitboard operator~() const;
+
+	friend Bitboard operator&(Bitboard lhs, const Bitboard& rhs) { return lhs &= rhs; }
+	friend Bitboard operator|(Bitboard lhs, const Bitboard& rhs) { return lhs |= rhs; }
+	friend Bitboard operator^(Bitboard lhs, const Bitboard& rhs) { return lhs ^= rhs; }
+	friend bool operator==(const Bitboard& lhs, const Bitboard& rhs) { return lhs.mWords == rhs.mWords; }
+	friend bool operator!=(const Bitboard& lhs, const Bitboard& rhs) { return lhs.mWords != rhs.mWords; }
+
+	// Returns the bit index of cell (x, y).
+	// Throws out_of_range for invalid coordinates.
+	static size_t index(size_t x, size_t y);
+
+	static size_t getHeight() { return HEIGHT; }
+	static size_t getWidth() { return WIDTH; }
+
+private:
+	static const size_t kBitsPerWord = 64;
+	static const size_t kNumWords = (kNumCells + kBitsPerWord - 1) / kBitsPerWord;
+
+	// Clears the bits beyond the last cell, after operations that may
+	// have set them.
+	void clearUnusedBits();
+
+	// Bits beyond kNumCells in the last word are always 0, so comparisons
+	// and count() can work on whole words.
+	std::array<uint64_t, kNumWords> mWords{};
+};
+
+template <size_t WIDTH, size_t HEIGHT>
+size_t Bitboard<WIDTH, HEIGHT>::index(size_t x, size_t y)
+{
+	if (x >= WIDTH || y >= HEIGHT) {
+		throw std::out_of_range("");
+	}
+	return x + y * WIDTH;
+}
+
+template <size_t WIDTH, size_t HEIGHT>
+Bitboard<WIDTH, HEIGHT> Bitboard<WIDTH, HEIGHT>::full()
+{
+	return ~Bitboard();
+}
+
+template <size_t WIDTH, size_t HEIGHT>
+void Bitboard<WIDTH, HEIGHT>::clearUnusedBits()
+{
+	if (kNumCells % kBitsPerWord != 0) {
+		mWords.back() &= (uint64_t(1) << (kNumCells % kBitsPerWord)) - 1;
+	}
+}
+
+template <size_t WIDTH, size_t HEIGHT>
+bool Bitboard<WIDTH, HEIGHT>::test(size_t x, size_t y) const
+{
+	size_t i = index(x, y);
+	return (mWords[i / kBitsPerWord] >> (i % kBitsPerWord)) & 1;
+}
+
+template <size_t WIDTH, size_t HEIGHT>
+void Bitboard<WIDTH, HEIGHT>::set(size_t x, size_t y)
+{
+	size_t i = index(x, y);
+	mWords[i / kBitsPerWord] |= uint64_t(1) << (i % kBitsPerWord);
+}
+
+template <size_t WIDTH, size_t HEIGHT>
+void Bitboard<WIDTH, HEIGHT>::reset(size_t x, size_t y)
+{
+	size_t i = index(x, y);
+	mWords[i / kBitsPerWord] &= ~(uint64_t(1) << (i % kBitsPerWord));
+}
+
+template <size_t WIDTH, size_t HEIGHT>
+size_t Bitboard<WIDTH, HEIGHT>::count() const
+{
+	size_t result = 0;
+	for (uint64_t word : mWords) {
+		result += std::bitset<kBitsPerWord>(word).count();
+	}
+	return result;
+}
+
+template <size_t WIDTH, size_t HEIGHT>
+bool Bitboard<WIDTH, HEIGHT>::any() const
+{
+	for (uint64_t word : mWords) {
+		if (word != 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+template <size_t WIDTH, size_t HEIGHT>
+template <typename Func>
+void Bitboard<WIDTH, HEIGHT>::forEachSet(Func func) const
+{
+	for (size_t word = 0; word < kNumWords; ++word) {
+		// Visit the set bits by clearing the lowest one until none are
+		// left, so empty cells cost nothing.
+		for (uint64_t bits = mWords[word]; bits != 0; bits &= bits - 1) {
+			// The number of trailing zeros is the number of bits below
+			// the lowest set bit.
+			size_t i = word * kBitsPerWord + std::bitset<kBitsPerWord>((bits & (~bits + 1)) - 1).count();
+			func(i % WIDTH, i / WIDTH);
+		}
+	}
+}
+
+template <size_t WIDTH, size_t HEIGHT>
+Bitboard<WIDTH, HEIGHT>& Bitboard<WIDTH, HEIGHT>::operator&=(const Bitboard& rhs)
+{
+	for (size_t word = 0; word < kNumWords; ++word) {
+		mWords[word] &= rhs.mWords[word];
+	}
+	return *this;
+}
+
+template <size_t WIDTH, size_t HEIGHT>
+Bitboard<WIDTH, HEIGHT>& Bitboard<WIDTH, HEIGHT>::operator|=(const Bitboard& rhs)
+{
+	for (size_t word = 0; word < kNumWords; ++word) {
+		mWords[word] |= rhs.mWords[word];
+	}
+	return *this;
+}
+
+template <size_t WIDTH, size_t HEIGHT>
+Bitboard<WIDTH, HEIGHT>& Bitboard<WIDTH, HEIGHT>::operator^=(const Bitboard& rhs)
+{
+	for (size_t word = 0; word < kNumWords; ++word) {
+		mWords[word] ^= rhs.mWords[word];
+	}
+	return *this;
+}
+
+template <size_t WIDTH, size_t HEIGHT>
+Bitboard<WIDTH, HEIGHT> Bitboard<WIDTH, HEIGHT>::operator~() const
+{
+	Bitboard result;
+	for (size_t word = 0; word < kNumWords; ++word) {
+		result.mWords[word] = ~mWords[word];
+	}
+	result.clearUnusedBits();
+	return result;
+}
+
+enum class Player { First, Second };
+
+// Board for games in which players take turns placing stones on empty
+// cells, and the first to get K stones in a row, horizontally,
+// vertically, or diagonally, wins: tic-tac-toe is ConnectBoard<3, 3, 3>,
+// gomoku is ConnectBoard<15, 15, 5>.
+//
+// Every player has a Bitboard of their stones. All possible lines of K
+// cells are precomputed as masks once per board type, so a line is
+// complete when (stones & line) == line, and the empty cells (the legal
+// moves) are the complement of both players' stones.
+template <size_t WIDTH, size_t HEIGHT, size_t K>
+class ConnectBoard
+{
+	static_assert(K > 0 && (K <= WIDTH || K <= HEIGHT), "K doesn't fit on the board.");
+
+public:
+	using Board = Bitboard<WIDTH, HEIGHT>;
+
+	// Places a stone of player in cell (x, y).
+	// Throws out_of_range for invalid coordinates, and invalid_argument
+	// if the cell is not empty.
+	void play(Player player, size_t x, size_t y);
+
+	// Removes the stone from cell (x, y), for undoing a move in a search.
+	// Throws out_of_range for invalid coordinates.
+	void undo(size_t x, size_t y);
+
+	const Board& getStones(Player player) const { return mStones[static_cast<size_t>(player)]; }
+
+	// Returns the empty cells, which are the legal moves.
+	Board getEmptyCells() const { return ~(mStones[0] | mStones[1]); }
+	bool isFull() const { return getEmptyCells().none(); }
+
+	// Returns true if player has K stones in a row anywhere.
+	bool hasWon(Player player) const;
+
+	// Returns true if placing a stone of player in cell (x, y) would
+	// complete a line. Only the lines through that cell are checked.
+	// Throws out_of_range for invalid coordinates.
+	bool wouldWin(Player player, size_t x, size_t y) const;
+
+	// Returns all lines of K cells.
+	static const std::vector<Board>& getLines();
+
+private:
+	// Returns, for every cell, the indices in getLines() of the lines
+	// containing that cell.
+	static const std::vector<std::vector<size_t>>& getLinesPerCell();
+
+	std::array<Board, 2> mStones;
+};
+
+template <size_t WIDTH, size_t HEIGHT, size_t K>
+const std::vector<Bitboard<WIDTH, HEIGHT>>& ConnectBoard<WIDTH, HEIGHT, K>::getLines()
+{
+	// Computed on first use; initialization of a local static is thread-safe.
+	static const std::vector<Board> lines = [] {
+		std::vector<Board> result;
+		// Directions: right, down, down-right, down-left.
+		const int directions[4][2] = { { 1, 0 }, { 0, 1 }, { 1, 1 }, { -1, 1 } };
+		for (const auto& [dx, dy] : directions) {
+			for (int y = 0; y < static_cast<int>(HEIGHT); ++y) {
+				for (int x = 0; x < static_cast<int>(WIDTH); ++x) {
+					int lastX = x + dx * static_cast<int>(K - 1);
+					int lastY = y + dy * static_cast<int>(K - 1);
+					if (lastX < 0 || lastX >= static_cast<int>(WIDTH) || lastY >= static_cast<int>(HEIGHT)) {
+						continue;
+					}
+					Board line;
+					for (int i = 0; i < static_cast<int>(K); ++i) {
+						line.set(x + i * dx, y + i * dy);
+					}
+					result.push_back(line);
+				}
+			}
+		}
+		return result;
+	}();
+	return lines;
+}
+
+template <size_t WIDTH, size_t HEIGHT, size_t K>
+const std::vector<std::vector<size_t>>& ConnectBoard<WIDTH, HEIGHT, K>::getLinesPerCell()
+{
+	static const std::vector<std::vector<size_t>> linesPerCell = [] {
+		std::vector<std::vector<size_t>> result(Board::kNumCells);
+		const auto& lines = getLines();
+		for (size_t line = 0; line < lines.size(); ++line) {
+			lines[line].forEachSet([&](size_t x, size_t y) {
+				result[Board::index(x, y)].push_back(line);
+			});
+		}
+		return result;
+	}();
+	return linesPerCell;
+}
+
+template <size_t WIDTH, size_t HEIGHT, size_t K>
+void ConnectBoard<WIDTH, HEIGHT, K>::play(Player player, size_t x, size_t y)
+{
+	if (!getEmptyCells().test(x, y)) {
+		throw std::invalid_argument("Cell is not empty.");
+	}
+	mStones[static_cast<size_t>(player)].set(x, y);
+}
+
+template <size_t WIDTH, size_t HEIGHT, size_t K>
+void ConnectBoard<WIDTH, HEIGHT, K>::undo(size_t x, size_t y)
+{
+	mStones[0].reset(x, y);
+	mStones[1].reset(x, y);
+}
+
+template <size_t WIDTH, size_t HEIGHT, size_t K>
+bool ConnectBoard<WIDTH, HEIGHT, K>::hasWon(Player player) const
+{
+	const Board& stones = getStones(player);
+	for (const auto& line : getLines()) {
+		if ((stones & line) == line) {
+			return true;
+		}
+	}
+	return false;
+}
+
+template <size_t WIDTH, size_t HEIGHT, size_t K>
+bool ConnectBoard<WIDTH, HEIGHT, K>::wouldWin(Player player, size_t x, size_t y) const
+{
+	Board stones = getStones(player);
+	stones.set(x, y);
+	const auto& lines = getLines();
+	for (size_t line : getLinesPerCell()[Board::index(x, y)]) {
+		if ((stones & lines[line]) == lines[line]) {
+			return true;
+		}
+	}
+	return false;
+}
+
+using TicTacToeBoard = ConnectBoard<3, 3, 3>;
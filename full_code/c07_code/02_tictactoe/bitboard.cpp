@@ -0,0 +1,58 @@
+#include "Bitboard.h"
+#include <iostream>
+
+using namespace std;
+
+Player opponent(Player player)
+{
+	return player == Player::First ? Player::Second : Player::First;
+}
+
+// Returns 1 if player, who is to move, wins with perfect play, -1 if
+// player loses, and 0 for a draw.
+int negamax(TicTacToeBoard& board, Player player)
+{
+	auto moves = board.getEmptyCells();
+	if (moves.none()) {
+		return 0;
+	}
+	int best = -1;
+	moves.forEachSet([&](size_t x, size_t y) {
+		if (best == 1) {
+			return;
+		}
+		if (board.wouldWin(player, x, y)) {
+			best = 1;
+			return;
+		}
+		board.play(player, x, y);
+		best = max(best, -negamax(board, opponent(player)));
+		board.undo(x, y);
+	});
+	return best;
+}
+
+int main()
+{
+	TicTacToeBoard board;
+	board.play(Player::First, 0, 0);    // X puts marker in position (0,0).
+	board.play(Player::Second, 2, 1);   // O puts marker in position (2,1).
+	cout << "Tic-tac-toe lines: " << TicTacToeBoard::getLines().size()
+		<< ", legal moves: " << board.getEmptyCells().count() << endl;
+
+	TicTacToeBoard empty;
+	cout << "Perfect play from the empty board: " << negamax(empty, Player::First) << endl;
+
+	// Gomoku: five in a row on a 15x15 board.
+	ConnectBoard<15, 15, 5> gomoku;
+	for (size_t i = 0; i < 4; ++i) {
+		gomoku.play(Player::First, 3 + i, 3 + i);
+	}
+	cout << "Gomoku lines: " << ConnectBoard<15, 15, 5>::getLines().size()
+		<< ", (7, 7) wins: " << gomoku.wouldWin(Player::First, 7, 7)
+		<< ", (8, 8) wins: " << gomoku.wouldWin(Player::First, 8, 8) << endl;
+	gomoku.play(Player::First, 7, 7);
+	cout << "First player has won: " << gomoku.hasWon(Player::First) << endl;
+
+	return 0;
+}
@@ -1,50 +1,108 @@
 #pragma once
 
+#include <cassert>
 #include <cstddef>
 #include <stdexcept>
 #include <optional>
 #include <utility>
 
+// All members are constexpr, so a Grid of a literal type, such as a
+// precomputed board or a filter kernel, can be built and read at compile
+// time. For that, Grid must be a literal type itself, which is why it
+// has no virtual destructor.
 template <typename T, size_t WIDTH, size_t HEIGHT>
 class Grid
 {
 public:
-	Grid() = default;
-	virtual ~Grid() = default;
+	constexpr Grid() = default;
 
 	// Explicitly default a copy constructor and copy assignment operator.
-	Grid(const Grid& src) = default;
-	Grid<T, WIDTH, HEIGHT>& operator=(const Grid& rhs) = default;
+	constexpr Grid(const Grid& src) = default;
+	constexpr Grid<T, WIDTH, HEIGHT>& operator=(const Grid& rhs) = default;
 
-	std::optional<T>& at(size_t x, size_t y);
-	const std::optional<T>& at(size_t x, size_t y) const;
-	
-	size_t getHeight() const { return HEIGHT; }
-	size_t getWidth() const { return WIDTH; }
+	constexpr std::optional<T>& at(size_t x, size_t y);
+	constexpr const std::optional<T>& at(size_t x, size_t y) const;
+
+	// Accessors without a run-time bounds check. The coordinates are
+	// template arguments, so they are verified at compile time.
+	template <size_t X, size_t Y>
+	constexpr std::optional<T>& at();
+	template <size_t X, size_t Y>
+	constexpr const std::optional<T>& at() const;
+
+	// Accessors for run-time coordinates without a bounds check, for inner
+	// loops that already know their coordinates are valid. Only builds
+	// without NDEBUG verify them, with an assert.
+	constexpr std::optional<T>& operator()(size_t x, size_t y);
+	constexpr const std::optional<T>& operator()(size_t x, size_t y) const;
+
+	// Stores a value in a cell. Unlike assigning a T to at(x, y), this can
+	// be used in constant expressions with C++17.
+	constexpr void set(size_t x, size_t y, const T& value);
+
+	static constexpr size_t getHeight() { return HEIGHT; }
+	static constexpr size_t getWidth() { return WIDTH; }
 
 private:
-	void verifyCoordinate(size_t x, size_t y) const;
+	constexpr void verifyCoordinate(size_t x, size_t y) const;
 
-	std::optional<T> mCells[WIDTH][HEIGHT];
+	std::optional<T> mCells[WIDTH][HEIGHT]{};
 };
 
 template <typename T, size_t WIDTH, size_t HEIGHT>
-void Grid<T, WIDTH, HEIGHT>::verifyCoordinate(size_t x, size_t y) const
+constexpr void Grid<T, WIDTH, HEIGHT>::verifyCoordinate(size_t x, size_t y) const
 {
+	// In a constant expression, reaching the throw is a compilation error.
 	if (x >= WIDTH || y >= HEIGHT) {
 		throw std::out_of_range("");
 	}
 }
 
 template <typename T, size_t WIDTH, size_t HEIGHT>
-const std::optional<T>& Grid<T, WIDTH, HEIGHT>::at(size_t x, size_t y) const
+constexpr const std::optional<T>& Grid<T, WIDTH, HEIGHT>::at(size_t x, size_t y) const
 {
 	verifyCoordinate(x, y);
 	return mCells[x][y];
 }
 
 template <typename T, size_t WIDTH, size_t HEIGHT>
-std::optional<T>& Grid<T, WIDTH, HEIGHT>::at(size_t x, size_t y)
+constexpr std::optional<T>& Grid<T, WIDTH, HEIGHT>::at(size_t x, size_t y)
 {
 	return const_cast<std::optional<T>&>(std::as_const(*this).at(x, y));
 }
+
+template <typename T, size_t WIDTH, size_t HEIGHT>
+template <size_t X, size_t Y>
+constexpr const std::optional<T>& Grid<T, WIDTH, HEIGHT>::at() const
+{
+	static_assert(X < WIDTH && Y < HEIGHT, "Coordinate outside the grid.");
+	return mCells[X][Y];
+}
+
+template <typename T, size_t WIDTH, size_t HEIGHT>
+template <size_t X, size_t Y>
+constexpr std::optional<T>& Grid<T, WIDTH, HEIGHT>::at()
+{
+	return const_cast<std::optional<T>&>(std::as_const(*this).template at<X, Y>());
+}
+
+template <typename T, size_t WIDTH, size_t HEIGHT>
+constexpr const std::optional<T>& Grid<T, WIDTH, HEIGHT>::operator()(size_t x, size_t y) const
+{
+	assert(x < WIDTH && y < HEIGHT);
+	return mCells[x][y];
+}
+
+template <typename T, size_t WIDTH, size_t HEIGHT>
+constexpr std::optional<T>& Grid<T, WIDTH, HEIGHT>::operator()(size_t x, size_t y)
+{
+	return const_cast<std::optional<T>&>(std::as_const(*this)(x, y));
+}
+
+template <typename T, size_t WIDTH, size_t HEIGHT>
+constexpr void Grid<T, WIDTH, HEIGHT>::set(size_t x, size_t y, const T& value)
+{
+	// std::optional's converting assignment is only constexpr since C++20,
+	// but copy-assigning a whole optional of a trivially copyable T is.
+	at(x, y) = std::optional<T>(value);
+}
@@ -8,6 +8,25 @@ constexpr size_t getHeight()
 	return 10;
 }
 
+// Builds a 3x3 Laplace kernel at compile time.
+constexpr Grid<int, 3, 3> makeLaplaceKernel()
+{
+	Grid<int, 3, 3> kernel;
+	for (size_t y = 0; y < kernel.getHeight(); ++y) {
+		for (size_t x = 0; x < kernel.getWidth(); ++x) {
+			bool center = (x == 1 && y == 1);
+			bool neighbor = !center && (x == 1 || y == 1);
+			kernel.set(x, y, center ? -4 : (neighbor ? 1 : 0));
+		}
+	}
+	return kernel;
+}
+
+constexpr auto kLaplaceKernel = makeLaplaceKernel();
+static_assert(kLaplaceKernel.at(1, 1) == -4);
+static_assert(kLaplaceKernel.at<0, 1>() == 1);
+static_assert(kLaplaceKernel(1, 0) == 1);
+
 int main()
 {
 	Grid<int, 10, 10> myGrid;
@@ -20,5 +39,20 @@ int main()
 
 	Grid<double, 2, getHeight()> myDoubleGrid;
 
+	// No run-time bounds check; at<3, 2>() would not compile.
+	myDoubleGrid.at<1, 9>() = 1.5;
+	cout << " " << myDoubleGrid.at<1, 9>().value_or(0);
+	cout << " " << kLaplaceKernel.at<2, 1>().value_or(0) << endl;
+
+	// No bounds check for run-time coordinates either, e.g. when applying
+	// the kernel in a loop that stays inside the grid.
+	int sum = 0;
+	for (size_t y = 0; y < kLaplaceKernel.getHeight(); ++y) {
+		for (size_t x = 0; x < kLaplaceKernel.getWidth(); ++x) {
+			sum += kLaplaceKernel(x, y).value_or(0);
+		}
+	}
+	cout << "Sum of the kernel: " << sum << endl;
+
 	return 0;
 }
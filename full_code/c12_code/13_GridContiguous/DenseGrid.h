@@ -0,0 +1,220 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <vector>
+#include <optional>
+#include <utility>
+#include "Grid.h"
+#include "GridView.h"
+
+// Grid storing its values in a dense row-major array of T, and tracking
+// which cells have a value in a separate bitmap, one bit per cell.
+// For arithmetic types this takes about half the memory of a Grid<T>,
+// because a std::optional<T> carries a flag plus padding for every cell.
+//
+// Empty cells hold a value-initialized T (0 for arithmetic types), so
+// bulk algorithms over dense() don't have to check for presence first.
+// T must be default constructible.
+//
+// Code that needs the std::optional<T>& interface can convert to and
+// from Grid<T>.
+template <typename T>
+class DenseGrid
+{
+public:
+	explicit DenseGrid(size_t width = kDefaultWidth, size_t height = kDefaultHeight);
+	explicit DenseGrid(const Grid<T>& grid);
+	virtual ~DenseGrid() = default;
+
+	// Explicitly default a copy constructor and copy assignment operator.
+	DenseGrid(const DenseGrid& src) = default;
+	DenseGrid<T>& operator=(const DenseGrid& rhs) = default;
+
+	// Explicitly default a move constructor and move assignment operator.
+	DenseGrid(DenseGrid&& src) = default;
+	DenseGrid<T>& operator=(DenseGrid&& rhs) = default;
+
+	// Returns true if the cell has a value.
+	bool has(size_t x, size_t y) const;
+
+	// Returns the value of the cell.
+	// Throws bad_optional_access if the cell is empty.
+	T& at(size_t x, size_t y);
+	const T& at(size_t x, size_t y) const;
+
+	// Returns a copy of the cell, or nullopt if the cell is empty.
+	std::optional<T> get(size_t x, size_t y) const;
+
+	// Stores a value in the cell, marking it as non-empty.
+	void set(size_t x, size_t y, const T& value);
+
+	// Makes the cell empty.
+	void reset(size_t x, size_t y);
+
+	// Returns the number of non-empty cells.
+	size_t count() const;
+
+	// Zero-copy view of all values, empty cells included. Writing
+	// through this view doesn't change which cells are empty.
+	RectView<T> dense();
+	RectView<const T> dense() const;
+
+	// The same values as one row-major array of getWidth() * getHeight()
+	// elements, for code that processes them in bulk, like the
+	// expressions in GridExpressions.h.
+	T* data() { return mValues.data(); }
+	const T* data() const { return mValues.data(); }
+
+	// Marks every cell as non-empty, keeping the values. Used after
+	// writing all values through dense() or data().
+	void setAllPresent();
+
+	// Converts to a Grid with the std::optional<T>& interface.
+	Grid<T> toGrid() const;
+
+	size_t getHeight() const { return mHeight; }
+	size_t getWidth() const { return mWidth; }
+
+	static const size_t kDefaultWidth = 10;
+	static const size_t kDefaultHeight = 10;
+
+private:
+	void verifyCoordinate(size_t x, size_t y) const;
+
+	static const size_t kBitsPerWord = 64;
+
+	std::vector<T> mValues;
+	std::vector<uint64_t> mPresent;
+	size_t mWidth, mHeight;
+};
+
+template <typename T>
+DenseGrid<T>::DenseGrid(size_t width, size_t height)
+	: mWidth(width)
+	, mHeight(height)
+{
+	mValues.resize(mWidth * mHeight);
+	mPresent.resize((mWidth * mHeight + kBitsPerWord - 1) / kBitsPerWord);
+}
+
+template <typename T>
+DenseGrid<T>::DenseGrid(const Grid<T>& grid)
+	: DenseGrid(grid.getWidth(), grid.getHeight())
+{
+	for (size_t y = 0; y < mHeight; ++y) {
+		for (size_t x = 0; x < mWidth; ++x) {
+			if (const auto& cell = grid.at(x, y)) {
+				set(x, y, *cell);
+			}
+		}
+	}
+}
+
+template <typename T>
+void DenseGrid<T>::verifyCoordinate(size_t x, size_t y) const
+{
+	if (x >= mWidth || y >= mHeight) {
+		throw std::out_of_range("");
+	}
+}
+
+template <typename T>
+bool DenseGrid<T>::has(size_t x, size_t y) const
+{
+	verifyCoordinate(x, y);
+	size_t index = x + y * mWidth;
+	return (mPresent[index / kBitsPerWord] >> (index % kBitsPerWord)) & 1;
+}
+
+template <typename T>
+const T& DenseGrid<T>::at(size_t x, size_t y) const
+{
+	if (!has(x, y)) {
+		throw std::bad_optional_access();
+	}
+	return mValues[x + y * mWidth];
+}
+
+template <typename T>
+T& DenseGrid<T>::at(size_t x, size_t y)
+{
+	return const_cast<T&>(std::as_const(*this).at(x, y));
+}
+
+template <typename T>
+std::optional<T> DenseGrid<T>::get(size_t x, size_t y) const
+{
+	if (!has(x, y)) {
+		return std::nullopt;
+	}
+	return mValues[x + y * mWidth];
+}
+
+template <typename T>
+void DenseGrid<T>::set(size_t x, size_t y, const T& value)
+{
+	verifyCoordinate(x, y);
+	size_t index = x + y * mWidth;
+	mValues[index] = value;
+	mPresent[index / kBitsPerWord] |= uint64_t(1) << (index % kBitsPerWord);
+}
+
+template <typename T>
+void DenseGrid<T>::reset(size_t x, size_t y)
+{
+	verifyCoordinate(x, y);
+	size_t index = x + y * mWidth;
+	mValues[index] = T{};
+	mPresent[index / kBitsPerWord] &= ~(uint64_t(1) << (index % kBitsPerWord));
+}
+
+template <typename T>
+size_t DenseGrid<T>::count() const
+{
+	size_t result = 0;
+	for (uint64_t word : mPresent) {
+		// Clear the lowest set bit until none are left.
+		for (; word != 0; word &= word - 1) {
+			++result;
+		}
+	}
+	return result;
+}
+
+template <typename T>
+void DenseGrid<T>::setAllPresent()
+{
+	const size_t numCells = mWidth * mHeight;
+	std::fill(std::begin(mPresent), std::end(mPresent), ~uint64_t(0));
+	// Keep the bits past the last cell cleared, so count() stays correct.
+	if (numCells % kBitsPerWord != 0) {
+		mPresent.back() = (uint64_t(1) << (numCells % kBitsPerWord)) - 1;
+	}
+}
+
+template <typename T>
+RectView<T> DenseGrid<T>::dense()
+{
+	return RectView<T>(mValues.data(), mWidth, mHeight, mWidth);
+}
+
+template <typename T>
+RectView<const T> DenseGrid<T>::dense() const
+{
+	return RectView<const T>(mValues.data(), mWidth, mHeight, mWidth);
+}
+
+template <typename T>
+Grid<T> DenseGrid<T>::toGrid() const
+{
+	Grid<T> result(mWidth, mHeight);
+	for (size_t y = 0; y < mHeight; ++y) {
+		for (size_t x = 0; x < mWidth; ++x) {
+			result.at(x, y) = get(x, y);
+		}
+	}
+	return result;
+}
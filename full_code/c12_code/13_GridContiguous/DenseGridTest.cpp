@@ -0,0 +1,47 @@
+#include "DenseGrid.h"
+#include <algorithm>
+#include <numeric>
+#include <iostream>
+
+using namespace std;
+
+int main()
+{
+	DenseGrid<double> myGrid(1000, 1000);
+	cout << "sizeof(optional<double>) = " << sizeof(optional<double>)
+		<< ", sizeof(double) = " << sizeof(double) << endl;
+
+	myGrid.set(1, 2, 3.5);
+	myGrid.set(4, 5, 1.5);
+	if (myGrid.has(1, 2)) {
+		cout << "Cell (1, 2) = " << myGrid.at(1, 2) << endl;
+	}
+	myGrid.reset(4, 5);
+	cout << "Cell (4, 5) = " << myGrid.get(4, 5).value_or(-1) << endl;
+	cout << "Non-empty cells: " << myGrid.count() << endl;
+
+	try {
+		myGrid.at(4, 5);
+	} catch (const bad_optional_access&) {
+		cout << "Cell (4, 5) is empty." << endl;
+	}
+
+	// Empty cells contain 0.0, so the sum can be computed over the dense
+	// values without checking for presence.
+	auto values = myGrid.dense();
+	cout << "Sum: " << accumulate(begin(values), end(values), 0.0) << endl;
+
+	// Scale a whole row in place.
+	auto row2 = values.row(2);
+	transform(begin(row2), end(row2), begin(row2), [](double d) { return d * 2; });
+	cout << "Cell (1, 2) = " << myGrid.at(1, 2) << endl;
+
+	// Convert to the std::optional<T>& interface and back.
+	Grid<double> compatible = myGrid.toGrid();
+	compatible.at(7, 7) = 42.0;
+	DenseGrid<double> roundTrip(compatible);
+	cout << "Cell (7, 7) = " << roundTrip.at(7, 7)
+		<< ", non-empty cells: " << roundTrip.count() << endl;
+
+	return 0;
+}
@@ -0,0 +1,177 @@
+#pragma once
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+#include <optional>
+#include <type_traits>
+#include <utility>
+#include "GridLayout.h"
+#include "GridView.h"
+
+// Grid storing all its cells in one contiguous buffer. The Layout policy
+// (see GridLayout.h) decides where a cell is stored in that buffer. With
+// the default RowMajorLayout, cell (x, y) is at index x + y * width, and
+// rows, columns, and sub-rectangles can be accessed as zero-copy views,
+// which provide iterators so they can be used directly with Standard
+// Library algorithms.
+template <typename T, typename Layout = RowMajorLayout>
+class Grid
+{
+public:
+	using LayoutType = Layout;
+
+	explicit Grid(size_t width = kDefaultWidth, size_t height = kDefaultHeight);
+	virtual ~Grid() = default;
+
+	// Explicitly default a copy constructor and copy assignment operator.
+	Grid(const Grid& src) = default;
+	Grid<T, Layout>& operator=(const Grid& rhs) = default;
+
+	// Explicitly default a move constructor and move assignment operator.
+	Grid(Grid&& src) = default;
+	Grid<T, Layout>& operator=(Grid&& rhs) = default;
+
+	std::optional<T>& at(size_t x, size_t y);
+	const std::optional<T>& at(size_t x, size_t y) const;
+
+	using RowView = StridedView<std::optional<T>>;
+	using ConstRowView = StridedView<const std::optional<T>>;
+	using ColumnView = StridedView<std::optional<T>>;
+	using ConstColumnView = StridedView<const std::optional<T>>;
+	using SubGridView = RectView<std::optional<T>>;
+	using ConstSubGridView = RectView<const std::optional<T>>;
+
+	// Views referring to the cells of this grid. Views don't copy any
+	// cells, but are invalidated when the grid is destroyed or moved.
+	// All of them throw out_of_range for invalid coordinates.
+	// Only available with RowMajorLayout.
+	RowView row(size_t y);
+	ConstRowView row(size_t y) const;
+	ColumnView column(size_t x);
+	ConstColumnView column(size_t x) const;
+	SubGridView subGrid(size_t x, size_t y, size_t width, size_t height);
+	ConstSubGridView subGrid(size_t x, size_t y, size_t width, size_t height) const;
+
+	// Iterators over all cells of the grid, row by row.
+	// Only available with RowMajorLayout.
+	using iterator = typename std::vector<std::optional<T>>::iterator;
+	using const_iterator = typename std::vector<std::optional<T>>::const_iterator;
+
+	iterator begin() { verifyRowMajor(); return std::begin(mCells); }
+	iterator end() { verifyRowMajor(); return std::end(mCells); }
+	const_iterator begin() const { verifyRowMajor(); return std::cbegin(mCells); }
+	const_iterator end() const { verifyRowMajor(); return std::cend(mCells); }
+
+	size_t getHeight() const { return mHeight; }
+	size_t getWidth() const { return mWidth; }
+
+	static const size_t kDefaultWidth = 10;
+	static const size_t kDefaultHeight = 10;
+
+private:
+	void verifyCoordinate(size_t x, size_t y) const;
+	static void verifyRowMajor()
+	{
+		static_assert(std::is_same_v<Layout, RowMajorLayout>,
+			"Views and iterators require RowMajorLayout.");
+	}
+
+	std::vector<std::optional<T>> mCells;
+	size_t mWidth, mHeight;
+	Layout mLayout;
+};
+
+template <typename T, typename Layout>
+Grid<T, Layout>::Grid(size_t width, size_t height)
+	: mWidth(width)
+	, mHeight(height)
+	, mLayout(width, height)
+{
+	// One allocation for all cells, instead of one per column.
+	mCells.resize(Layout::getBufferSize(mWidth, mHeight));
+}
+
+template <typename T, typename Layout>
+void Grid<T, Layout>::verifyCoordinate(size_t x, size_t y) const
+{
+	if (x >= mWidth || y >= mHeight) {
+		throw std::out_of_range("");
+	}
+}
+
+template <typename T, typename Layout>
+const std::optional<T>& Grid<T, Layout>::at(size_t x, size_t y) const
+{
+	verifyCoordinate(x, y);
+	return mCells[mLayout.index(x, y)];
+}
+
+template <typename T, typename Layout>
+std::optional<T>& Grid<T, Layout>::at(size_t x, size_t y)
+{
+	return const_cast<std::optional<T>&>(std::as_const(*this).at(x, y));
+}
+
+template <typename T, typename Layout>
+typename Grid<T, Layout>::ConstRowView Grid<T, Layout>::row(size_t y) const
+{
+	verifyRowMajor();
+	return ConstSubGridView(mCells.data(), mWidth, mHeight, mWidth).row(y);
+}
+
+template <typename T, typename Layout>
+typename Grid<T, Layout>::RowView Grid<T, Layout>::row(size_t y)
+{
+	verifyRowMajor();
+	return SubGridView(mCells.data(), mWidth, mHeight, mWidth).row(y);
+}
+
+template <typename T, typename Layout>
+typename Grid<T, Layout>::ConstColumnView Grid<T, Layout>::column(size_t x) const
+{
+	verifyRowMajor();
+	return ConstSubGridView(mCells.data(), mWidth, mHeight, mWidth).column(x);
+}
+
+template <typename T, typename Layout>
+typename Grid<T, Layout>::ColumnView Grid<T, Layout>::column(size_t x)
+{
+	verifyRowMajor();
+	return SubGridView(mCells.data(), mWidth, mHeight, mWidth).column(x);
+}
+
+template <typename T, typename Layout>
+typename Grid<T, Layout>::ConstSubGridView Grid<T, Layout>::subGrid(size_t x, size_t y,
+	size_t width, size_t height) const
+{
+	verifyRowMajor();
+	return ConstSubGridView(mCells.data(), mWidth, mHeight, mWidth).subGrid(x, y, width, height);
+}
+
+template <typename T, typename Layout>
+typename Grid<T, Layout>::SubGridView Grid<T, Layout>::subGrid(size_t x, size_t y,
+	size_t width, size_t height)
+{
+	verifyRowMajor();
+	return SubGridView(mCells.data(), mWidth, mHeight, mWidth).subGrid(x, y, width, height);
+}
+
+// Calls func(x, y, width, height) for every tile of the grid, in the order
+// in which the layout stores them. Tiles at the right and bottom edges of
+// the grid can be smaller than the tile size of the layout.
+// Processing a grid tile by tile keeps the neighborhood of every cell in
+// the cache, which matters for stencils and other neighborhood operations.
+template <typename T, typename Layout, typename Func>
+void forEachTile(const Grid<T, Layout>& grid, Func func)
+{
+	const size_t tileWidth = Layout::kTileWidth;
+	const size_t tileHeight = Layout::kTileHeight;
+	for (size_t y = 0; y < grid.getHeight(); y += tileHeight) {
+		for (size_t x = 0; x < grid.getWidth(); x += tileWidth) {
+			func(x, y, std::min(tileWidth, grid.getWidth() - x),
+				std::min(tileHeight, grid.getHeight() - y));
+		}
+	}
+}
@@ -0,0 +1,188 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "Grid.h"
+
+// Parallel algorithms over all cells of a Grid. They split the grid into
+// bands of rows, and distribute the bands over as many threads as the
+// hardware supports. Within a band, rows of a RowMajorLayout grid are
+// accessed through row views, so there is no bounds check per cell.
+//
+// The functions passed to these algorithms are called concurrently from
+// several threads, so they must not modify shared state without
+// synchronization. Exceptions thrown by them are rethrown in the
+// calling thread.
+
+// Tells parallelReduce() how to split up the work.
+enum class ReductionOrder
+{
+	// Cells are reduced in bands of kGridBandHeight rows, and the bands are
+	// combined from top to bottom. The result doesn't depend on the number
+	// of threads, even for non-associative operations such as
+	// floating-point addition.
+	Deterministic,
+	// One band per thread. The result of a non-associative operation can
+	// differ between machines with a different number of cores.
+	Unordered
+};
+
+// Number of rows per band handed to a thread.
+const size_t kGridBandHeight = 16;
+
+// Calls func(firstRow, lastRow, band) for consecutive bands of bandHeight
+// rows (the last one can be smaller). The bands are distributed over a
+// number of threads, the calling thread included.
+template <typename Func>
+void runInRowBands(size_t numRows, size_t bandHeight, Func func)
+{
+	const size_t numBands = (numRows + bandHeight - 1) / bandHeight;
+	const size_t numThreads = std::min<size_t>(numBands,
+		std::max(1u, std::thread::hardware_concurrency()));
+
+	std::atomic<size_t> nextBand{ 0 };
+	std::vector<std::exception_ptr> errors(numThreads);
+	auto worker = [&](size_t threadIndex) {
+		try {
+			// Every thread keeps taking the next unprocessed band.
+			for (size_t band = nextBand++; band < numBands; band = nextBand++) {
+				size_t firstRow = band * bandHeight;
+				func(firstRow, std::min(firstRow + bandHeight, numRows), band);
+			}
+		} catch (...) {
+			errors[threadIndex] = std::current_exception();
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (size_t i = 1; i < numThreads; ++i) {
+		threads.emplace_back(worker, i);
+	}
+	worker(0);
+	for (auto& t : threads) {
+		t.join();
+	}
+
+	for (auto& error : errors) {
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+}
+
+// Calls func(x, y, cell) for every cell in rows [firstRow, lastRow).
+// GridType can be a const or non-const Grid.
+template <typename GridType, typename Func>
+void forEachCellInRows(GridType& grid, size_t firstRow, size_t lastRow, Func func)
+{
+	using Layout = typename std::remove_const_t<GridType>::LayoutType;
+	for (size_t y = firstRow; y < lastRow; ++y) {
+		if constexpr (std::is_same_v<Layout, RowMajorLayout>) {
+			size_t x = 0;
+			for (auto& cell : grid.row(y)) {
+				func(x++, y, cell);
+			}
+		} else {
+			for (size_t x = 0; x < grid.getWidth(); ++x) {
+				func(x, y, grid.at(x, y));
+			}
+		}
+	}
+}
+
+// Calls func(x, y, cell) for every cell of the grid, in parallel.
+template <typename T, typename Layout, typename Func>
+void parallelForEachCell(Grid<T, Layout>& grid, Func func)
+{
+	runInRowBands(grid.getHeight(), kGridBandHeight,
+		[&](size_t firstRow, size_t lastRow, size_t /*band*/) {
+			forEachCellInRows(grid, firstRow, lastRow, func);
+		});
+}
+
+// Stores func(cell) in the corresponding cell of out, for every cell of
+// in, in parallel. func receives a const std::optional<T>&, and returns
+// a value assignable to std::optional<U>.
+// Throws invalid_argument if the grids have different dimensions.
+template <typename T, typename LayoutIn, typename U, typename LayoutOut, typename Func>
+void parallelTransform(const Grid<T, LayoutIn>& in, Grid<U, LayoutOut>& out, Func func)
+{
+	if (in.getWidth() != out.getWidth() || in.getHeight() != out.getHeight()) {
+		throw std::invalid_argument("Grids have different dimensions.");
+	}
+	runInRowBands(in.getHeight(), kGridBandHeight,
+		[&](size_t firstRow, size_t lastRow, size_t /*band*/) {
+			if constexpr (std::is_same_v<LayoutIn, RowMajorLayout> &&
+				std::is_same_v<LayoutOut, RowMajorLayout>) {
+				for (size_t y = firstRow; y < lastRow; ++y) {
+					auto inRow = in.row(y);
+					auto outRow = out.row(y);
+					std::transform(std::begin(inRow), std::end(inRow), std::begin(outRow), func);
+				}
+			} else {
+				forEachCellInRows(out, firstRow, lastRow,
+					[&](size_t x, size_t y, std::optional<U>& cell) { cell = func(in.at(x, y)); });
+			}
+		});
+}
+
+// Reduces all cells of the grid in parallel: every cell is mapped to a
+// value with transformOp(cell), and the values are combined with
+// reduceOp(value1, value2). init must be an identity element of reduceOp
+// (for example 0 for addition), because it's used as the start value of
+// every band.
+template <typename T, typename Layout, typename Value, typename ReduceOp, typename TransformOp>
+Value parallelReduce(const Grid<T, Layout>& grid, Value init, ReduceOp reduceOp,
+	TransformOp transformOp, ReductionOrder order = ReductionOrder::Deterministic)
+{
+	size_t bandHeight = kGridBandHeight;
+	if (order == ReductionOrder::Unordered) {
+		size_t numThreads = std::max(1u, std::thread::hardware_concurrency());
+		bandHeight = std::max<size_t>(1, (grid.getHeight() + numThreads - 1) / numThreads);
+	}
+
+	// Every band stores its result in its own element. These are optionals
+	// instead of plain Values, because concurrently writing elements of a
+	// vector<bool> is not safe.
+	std::vector<std::optional<Value>> partials((grid.getHeight() + bandHeight - 1) / bandHeight);
+	runInRowBands(grid.getHeight(), bandHeight,
+		[&](size_t firstRow, size_t lastRow, size_t band) {
+			Value partial = init;
+			forEachCellInRows(grid, firstRow, lastRow,
+				[&](size_t, size_t, const std::optional<T>& cell) {
+					partial = reduceOp(partial, transformOp(cell));
+				});
+			partials[band] = partial;
+		});
+
+	// Combine the partial results from top to bottom.
+	Value result = init;
+	for (const auto& partial : partials) {
+		result = reduceOp(result, *partial);
+	}
+	return result;
+}
+
+// Computes every cell of out as func(in, x, y), in parallel. func can
+// read any cell of in, such as the neighbors of (x, y) for a stencil.
+// in and out must be different grids.
+// Throws invalid_argument if the grids have different dimensions.
+template <typename T, typename Layout, typename Func>
+void parallelStencilApply(const Grid<T, Layout>& in, Grid<T, Layout>& out, Func func)
+{
+	if (in.getWidth() != out.getWidth() || in.getHeight() != out.getHeight()) {
+		throw std::invalid_argument("Grids have different dimensions.");
+	}
+	runInRowBands(in.getHeight(), kGridBandHeight,
+		[&](size_t firstRow, size_t lastRow, size_t /*band*/) {
+			forEachCellInRows(out, firstRow, lastRow,
+				[&](size_t x, size_t y, std::optional<T>& cell) { cell = func(in, x, y); });
+		});
+}
@@ -0,0 +1,63 @@
+#include "Grid.h"
+#include "GridAlgorithms.h"
+#include <cmath>
+#include <iostream>
+
+using namespace std;
+
+int main()
+{
+	const size_t size = 1000;
+	Grid<double> grid(size, size);
+
+	// Initialize all cells in parallel.
+	parallelForEachCell(grid, [](size_t x, size_t y, optional<double>& cell) {
+		cell = sin(x * 0.01) * cos(y * 0.01);
+	});
+
+	// Compute the squares of all cells into another grid.
+	Grid<double> squares(size, size);
+	parallelTransform(grid, squares, [](const optional<double>& cell) {
+		return cell ? optional<double>(*cell * *cell) : nullopt;
+	});
+
+	// Sum all cells. The deterministic order gives the same result on
+	// every machine, the unordered one can differ in the last digits.
+	auto plus = [](double a, double b) { return a + b; };
+	auto valueOf = [](const optional<double>& cell) { return cell.value_or(0.0); };
+	cout.precision(17);
+	cout << "Sum of squares (deterministic): "
+		<< parallelReduce(squares, 0.0, plus, valueOf) << endl;
+	cout << "Sum of squares (unordered):     "
+		<< parallelReduce(squares, 0.0, plus, valueOf, ReductionOrder::Unordered) << endl;
+
+	// Smooth the grid with a 5-point stencil.
+	Grid<double> smoothed(size, size);
+	parallelStencilApply(grid, smoothed, [](const Grid<double>& in, size_t x, size_t y) {
+		if (x == 0 || y == 0 || x == in.getWidth() - 1 || y == in.getHeight() - 1) {
+			return in.at(x, y);
+		}
+		return optional<double>(0.2 * (*in.at(x, y) + *in.at(x - 1, y) + *in.at(x + 1, y)
+			+ *in.at(x, y - 1) + *in.at(x, y + 1)));
+	});
+	cout << "Smoothed cell (500, 500): " << smoothed.at(500, 500).value_or(0) << endl;
+
+	// The algorithms also work with a tiled layout.
+	Grid<int, TiledLayout<64>> tiled(300, 200);
+	parallelForEachCell(tiled, [](size_t, size_t, optional<int>& cell) { cell = 1; });
+	cout << "Number of cells: " << parallelReduce(tiled, 0, plus,
+		[](const optional<int>& cell) { return cell.value_or(0); }) << endl;
+
+	// Exceptions thrown in a worker thread are rethrown in this thread.
+	try {
+		parallelForEachCell(grid, [](size_t x, size_t y, optional<double>&) {
+			if (x == 10 && y == 900) {
+				throw runtime_error("Error while processing cell (10, 900)");
+			}
+		});
+	} catch (const runtime_error& e) {
+		cout << "Caught: " << e.what() << endl;
+	}
+
+	return 0;
+}
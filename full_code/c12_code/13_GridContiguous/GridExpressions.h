@@ -0,0 +1,342 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "DenseGrid.h"
+#include "Grid.h"
+#include "SimdPack.h"
+
+// Element-wise arithmetic on grids of arithmetic types, implemented with
+// expression templates. An expression such as
+//     fusedMultiplyAdd(a, b, c) / 2.0
+// doesn't compute anything. It builds a small object describing the
+// computation, which assign() or evaluate() then executes in a single
+// pass over the cells, without temporary grids. The loop processes a
+// whole SIMD pack (see SimdPack.h) per iteration, and uses scalar
+// operations for the remaining cells.
+//
+// Operands can be DenseGrids, row-major Grids, expressions, and scalars.
+// Both grids are read in row-major order, and empty cells take part with
+// a value-initialized T, as in DenseGrid::dense(). A DenseGrid operand is
+// loaded straight from its value array; a Grid operand first has to
+// gather the values out of its std::optional cells, so DenseGrid is the
+// faster choice for bulk arithmetic.
+//
+// Supported are + - * / between operands, fusedMultiplyAdd(a, b, c),
+// clampElements(a, low, high), the comparisons < <= > >= == != producing
+// masks, and where(mask, a, b) to select between two expressions. A mask
+// can be evaluated into a GridMask, which stores 0 or 1 per cell.
+//
+// Expressions refer to the grids they use; they must not outlive them.
+
+using GridMask = DenseGrid<unsigned char>;
+
+// Width and height of an expression.
+using GridExtents = std::array<size_t, 2>;
+
+// Base class of all expressions, using the curiously recurring template
+// pattern to get at the actual expression type.
+template <typename Derived>
+class GridExpression
+{
+public:
+	const Derived& derived() const { return static_cast<const Derived&>(*this); }
+};
+
+// Expression reading the values of a DenseGrid.
+template <typename T>
+class DenseGridLeaf : public GridExpression<DenseGridLeaf<T>>
+{
+	static_assert(std::is_arithmetic_v<T>, "Expressions need an arithmetic element type.");
+
+public:
+	using value_type = T;
+	static const bool kIsMask = false;
+
+	explicit DenseGridLeaf(const DenseGrid<T>& grid)
+		: mData(grid.data()), mExtents{ grid.getWidth(), grid.getHeight() } {}
+
+	const GridExtents& getExtents() const { return mExtents; }
+
+	template <typename Pack>
+	Pack eval(size_t i) const { return Pack::load(mData + i); }
+
+private:
+	const T* mData;
+	GridExtents mExtents;
+};
+
+// Expression reading the cells of a row-major Grid.
+template <typename T>
+class GridLeaf : public GridExpression<GridLeaf<T>>
+{
+	static_assert(std::is_arithmetic_v<T>, "Expressions need an arithmetic element type.");
+
+public:
+	using value_type = T;
+	static const bool kIsMask = false;
+
+	explicit GridLeaf(const Grid<T>& grid)
+		: mCells(std::begin(grid)), mExtents{ grid.getWidth(), grid.getHeight() } {}
+
+	const GridExtents& getExtents() const { return mExtents; }
+
+	template <typename Pack>
+	Pack eval(size_t i) const
+	{
+		T values[Pack::kSize];
+		for (size_t k = 0; k < Pack::kSize; ++k) {
+			values[k] = mCells[i + k].value_or(T{});
+		}
+		return Pack::load(values);
+	}
+
+private:
+	typename Grid<T>::const_iterator mCells;
+	GridExtents mExtents;
+};
+
+// Expression with the same scalar value for every cell. It takes the
+// element type and the extents of the other operands.
+template <typename S>
+class ScalarLeaf : public GridExpression<ScalarLeaf<S>>
+{
+public:
+	explicit ScalarLeaf(S value) : mValue(value) {}
+
+	template <typename Pack>
+	Pack eval(size_t) const
+	{
+		return Pack::broadcast(static_cast<typename Pack::value_type>(mValue));
+	}
+
+private:
+	S mValue;
+};
+
+template <typename T>
+struct IsScalarLeaf : std::false_type {};
+template <typename S>
+struct IsScalarLeaf<ScalarLeaf<S>> : std::true_type {};
+
+// Finds the first operand that is not a scalar; it determines the element
+// type and the extents of an expression.
+template <typename First, typename... Rest>
+constexpr auto firstGridOperand(const First& first, const Rest&... rest)
+	-> decltype(auto)
+{
+	if constexpr (IsScalarLeaf<First>::value) {
+		return firstGridOperand(rest...);
+	} else {
+		return (first);
+	}
+}
+
+template <typename... Args>
+using FirstGridOperand = std::decay_t<decltype(firstGridOperand(std::declval<const Args&>()...))>;
+
+// Expression applying Op to the results of its operands. Op is a class
+// with a static template member function apply() that works on packs.
+template <typename Op, typename... Args>
+class GridNode : public GridExpression<GridNode<Op, Args...>>
+{
+public:
+	using value_type = typename FirstGridOperand<Args...>::value_type;
+	static const bool kIsMask = Op::kIsMask;
+
+	// Throws invalid_argument if the grid operands have different sizes.
+	explicit GridNode(const Args&... args)
+		: mArgs(args...)
+		, mExtents(firstGridOperand(args...).getExtents())
+	{
+		auto verify = [this](const auto& arg) {
+			using ArgType = std::decay_t<decltype(arg)>;
+			if constexpr (!IsScalarLeaf<ArgType>::value) {
+				static_assert(std::is_same_v<typename ArgType::value_type, value_type>,
+					"All grids in an expression need the same element type.");
+				if (arg.getExtents() != mExtents) {
+					throw std::invalid_argument("Grids have different sizes.");
+				}
+			}
+		};
+		(verify(args), ...);
+	}
+
+	const GridExtents& getExtents() const { return mExtents; }
+
+	template <typename Pack>
+	decltype(auto) eval(size_t i) const
+	{
+		return std::apply([i](const auto&... args) {
+			return Op::apply(args.template eval<Pack>(i)...);
+		}, mArgs);
+	}
+
+private:
+	std::tuple<Args...> mArgs;
+	GridExtents mExtents;
+};
+
+// Converts the operands of the operators and functions below to
+// expressions: grids become leaves, scalars become scalar leaves, and
+// expressions stay as they are.
+template <typename T>
+DenseGridLeaf<T> toExpression(const DenseGrid<T>& grid) { return DenseGridLeaf<T>(grid); }
+
+template <typename T>
+GridLeaf<T> toExpression(const Grid<T>& grid) { return GridLeaf<T>(grid); }
+
+template <typename Derived>
+const Derived& toExpression(const GridExpression<Derived>& expression) { return expression.derived(); }
+
+template <typename S, typename = std::enable_if_t<std::is_arithmetic_v<S>>>
+ScalarLeaf<S> toExpression(S value) { return ScalarLeaf<S>(value); }
+
+template <typename T>
+struct IsGridOperand : std::is_base_of<GridExpression<T>, T> {};
+template <typename T>
+struct IsGridOperand<DenseGrid<T>> : std::true_type {};
+template <typename T>
+struct IsGridOperand<Grid<T>> : std::true_type {};
+
+// The operators and functions are only available if at least one of the
+// operands is a grid or an expression, and all others are scalars.
+template <typename... Args>
+constexpr bool kIsGridExpression = (IsGridOperand<std::decay_t<Args>>::value || ...) &&
+	((IsGridOperand<std::decay_t<Args>>::value || std::is_arithmetic_v<std::decay_t<Args>>) && ...);
+
+template <typename Op, typename... Args>
+auto makeNode(const Args&... args)
+{
+	return GridNode<Op, std::decay_t<decltype(toExpression(args))>...>(toExpression(args)...);
+}
+
+// The operations on packs.
+struct AddOp { static const bool kIsMask = false; template <typename P> static P apply(P a, P b) { return a + b; } };
+struct SubOp { static const bool kIsMask = false; template <typename P> static P apply(P a, P b) { return a - b; } };
+struct MulOp { static const bool kIsMask = false; template <typename P> static P apply(P a, P b) { return a * b; } };
+struct DivOp { static const bool kIsMask = false; template <typename P> static P apply(P a, P b) { return a / b; } };
+struct FmaOp { static const bool kIsMask = false; template <typename P> static P apply(P a, P b, P c) { return fusedMultiplyAdd(a, b, c); } };
+struct ClampOp { static const bool kIsMask = false; template <typename P> static P apply(P a, P low, P high) { return minimum(maximum(a, low), high); } };
+struct LessOp { static const bool kIsMask = true; template <typename P> static auto apply(P a, P b) { return a < b; } };
+struct LessEqualOp { static const bool kIsMask = true; template <typename P> static auto apply(P a, P b) { return a <= b; } };
+struct GreaterOp { static const bool kIsMask = true; template <typename P> static auto apply(P a, P b) { return a > b; } };
+struct GreaterEqualOp { static const bool kIsMask = true; template <typename P> static auto apply(P a, P b) { return a >= b; } };
+struct EqualOp { static const bool kIsMask = true; template <typename P> static auto apply(P a, P b) { return a == b; } };
+struct NotEqualOp { static const bool kIsMask = true; template <typename P> static auto apply(P a, P b) { return a != b; } };
+struct WhereOp { static const bool kIsMask = false; template <typename M, typename P> static P apply(M mask, P a, P b) { return where(mask, a, b); } };
+
+template <typename L, typename R, typename = std::enable_if_t<kIsGridExpression<L, R>>>
+auto operator+(const L& lhs, const R& rhs) { return makeNode<AddOp>(lhs, rhs); }
+template <typename L, typename R, typename = std::enable_if_t<kIsGridExpression<L, R>>>
+auto operator-(const L& lhs, const R& rhs) { return makeNode<SubOp>(lhs, rhs); }
+template <typename L, typename R, typename = std::enable_if_t<kIsGridExpression<L, R>>>
+auto operator*(const L& lhs, const R& rhs) { return makeNode<MulOp>(lhs, rhs); }
+template <typename L, typename R, typename = std::enable_if_t<kIsGridExpression<L, R>>>
+auto operator/(const L& lhs, const R& rhs) { return makeNode<DivOp>(lhs, rhs); }
+
+template <typename L, typename R, typename = std::enable_if_t<kIsGridExpression<L, R>>>
+auto operator<(const L& lhs, const R& rhs) { return makeNode<LessOp>(lhs, rhs); }
+template <typename L, typename R, typename = std::enable_if_t<kIsGridExpression<L, R>>>
+auto operator<=(const L& lhs, const R& rhs) { return makeNode<LessEqualOp>(lhs, rhs); }
+template <typename L, typename R, typename = std::enable_if_t<kIsGridExpression<L, R>>>
+auto operator>(const L& lhs, const R& rhs) { return makeNode<GreaterOp>(lhs, rhs); }
+template <typename L, typename R, typename = std::enable_if_t<kIsGridExpression<L, R>>>
+auto operator>=(const L& lhs, const R& rhs) { return makeNode<GreaterEqualOp>(lhs, rhs); }
+template <typename L, typename R, typename = std::enable_if_t<kIsGridExpression<L, R>>>
+auto operator==(const L& lhs, const R& rhs) { return makeNode<EqualOp>(lhs, rhs); }
+template <typename L, typename R, typename = std::enable_if_t<kIsGridExpression<L, R>>>
+auto operator!=(const L& lhs, const R& rhs) { return makeNode<NotEqualOp>(lhs, rhs); }
+
+// Computes a * b + c, with a fused multiply-add instruction if available.
+template <typename A, typename B, typename C, typename = std::enable_if_t<kIsGridExpression<A, B, C>>>
+auto fusedMultiplyAdd(const A& a, const B& b, const C& c) { return makeNode<FmaOp>(a, b, c); }
+
+// Limits every cell to the range [low, high]. NaN values become low, in
+// the SIMD packs and in the scalar remainder alike.
+template <typename A, typename L, typename H, typename = std::enable_if_t<kIsGridExpression<A, L, H>>>
+auto clampElements(const A& a, const L& low, const H& high) { return makeNode<ClampOp>(a, low, high); }
+
+// Selects the cell of a where mask is set, and of b elsewhere.
+// mask must be a comparison expression.
+template <typename M, typename A, typename B, typename = std::enable_if_t<kIsGridExpression<A, B>>>
+auto where(const GridExpression<M>& mask, const A& a, const B& b)
+{
+	static_assert(M::kIsMask, "The first argument of where() must be a comparison.");
+	return makeNode<WhereOp>(mask.derived(), a, b);
+}
+
+// Runs the evaluation loop: store(result, i, count) receives a pack or a
+// mask with the results for count cells, starting at row-major index i.
+template <typename T, typename Expr, typename Store>
+void evaluateInto(const Expr& expr, size_t numCells, Store store)
+{
+	static_assert(Expr::kIsMask ? std::is_same_v<T, unsigned char> : std::is_same_v<T, typename Expr::value_type>,
+		"Evaluate comparisons into a GridMask, and other expressions into a grid of their element type.");
+	using Pack = SimdPackFor_t<typename Expr::value_type>;
+	using Scalar = ScalarPack<typename Expr::value_type>;
+	size_t i = 0;
+	for (; i + Pack::kSize <= numCells; i += Pack::kSize) {
+		store(expr.template eval<Pack>(i), i, Pack::kSize);
+	}
+	for (; i < numCells; ++i) {
+		store(expr.template eval<Scalar>(i), i, 1);
+	}
+}
+
+template <typename Dest, typename Expr>
+void verifyExtents(const Dest& dest, const Expr& expr)
+{
+	if (GridExtents{ dest.getWidth(), dest.getHeight() } != expr.getExtents()) {
+		throw std::invalid_argument("Grids have different sizes.");
+	}
+}
+
+// Evaluates expression into dest, in one pass over all cells, and marks
+// every cell of dest as non-empty. dest can be one of the grids used in
+// the expression. A comparison must be evaluated into a GridMask, any
+// other expression into a grid with the element type of the expression.
+// Throws invalid_argument if dest has a different size.
+template <typename T, typename Expr>
+void assign(DenseGrid<T>& dest, const GridExpression<Expr>& expression)
+{
+	const Expr& expr = expression.derived();
+	verifyExtents(dest, expr);
+	T* out = dest.data();
+	evaluateInto<T>(expr, dest.getWidth() * dest.getHeight(),
+		[out](const auto& result, size_t i, size_t) { result.store(out + i); });
+	dest.setAllPresent();
+}
+
+// Same for a row-major Grid. The results are scattered into the
+// std::optional cells one by one.
+template <typename T, typename Expr>
+void assign(Grid<T>& dest, const GridExpression<Expr>& expression)
+{
+	const Expr& expr = expression.derived();
+	verifyExtents(dest, expr);
+	auto out = std::begin(dest);
+	evaluateInto<T>(expr, dest.getWidth() * dest.getHeight(), [out](const auto& result, size_t i, size_t count) {
+		T values[SimdPackFor_t<typename Expr::value_type>::kSize];
+		result.store(values);
+		for (size_t k = 0; k < count; ++k) {
+			out[i + k] = values[k];
+		}
+	});
+}
+
+// Returns a new DenseGrid, or a new GridMask for a comparison, with the
+// result of the expression.
+template <typename Expr>
+auto evaluate(const GridExpression<Expr>& expression)
+{
+	using ResultType = std::conditional_t<Expr::kIsMask, unsigned char, typename Expr::value_type>;
+	const GridExtents& extents = expression.derived().getExtents();
+	DenseGrid<ResultType> result(extents[0], extents[1]);
+	assign(result, expression);
+	return result;
+}
@@ -0,0 +1,80 @@
+#include "DenseGrid.h"
+#include "Grid.h"
+#include "GridExpressions.h"
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+
+using namespace std;
+
+int main()
+{
+	// 7 x 9 cells, so the last pack of every width is incomplete.
+	DenseGrid<double> a(7, 9);
+	DenseGrid<double> b(7, 9);
+	Grid<double> c(7, 9);
+	for (size_t y = 0; y < a.getHeight(); ++y) {
+		for (size_t x = 0; x < a.getWidth(); ++x) {
+			a.set(x, y, static_cast<double>(x + y * 7));
+			b.set(x, y, 0.5);
+			// Leave every third cell of c empty; it counts as 0.
+			if ((x + y) % 3 != 0) {
+				c.at(x, y) = static_cast<double>(x % 5);
+			}
+		}
+	}
+
+	// Evaluated in one pass, without temporary grids. DenseGrid and Grid
+	// operands can be mixed.
+	auto result = evaluate(fusedMultiplyAdd(a, b, c) - 1.0);
+	auto clamped = evaluate(clampElements(a * 2.0, 10.0, 50.0));
+	auto larger = evaluate(a > c * 4.0);
+	auto selected = evaluate(where(a < 20.0, a, 0.0 - a));
+
+	size_t mismatches = 0;
+	for (size_t y = 0; y < a.getHeight(); ++y) {
+		for (size_t x = 0; x < a.getWidth(); ++x) {
+			double va = a.at(x, y);
+			double vc = c.at(x, y).value_or(0.0);
+			mismatches += (result.at(x, y) != va * 0.5 + vc - 1.0);
+			mismatches += (clamped.at(x, y) != min(max(va * 2.0, 10.0), 50.0));
+			mismatches += (larger.at(x, y) != (va > vc * 4.0));
+			mismatches += (selected.at(x, y) != (va < 20.0 ? va : -va));
+		}
+	}
+	cout << "Elements per pack: " << SimdPackFor_t<double>::kSize
+		<< ", mismatches with scalar loop: " << mismatches
+		<< ", non-empty result cells: " << result.count() << endl;
+
+	// NaN clamps to the lower bound, whether it is in a full pack or in
+	// the scalar remainder.
+	DenseGrid<double> withNaN(7, 1);
+	for (size_t x = 0; x < withNaN.getWidth(); ++x) {
+		withNaN.set(x, 0, numeric_limits<double>::quiet_NaN());
+	}
+	auto clampedNaN = evaluate(clampElements(withNaN, -1.0, 1.0));
+	auto values = clampedNaN.dense();
+	cout << "NaN cells clamped to the lower bound: "
+		<< count(begin(values), end(values), -1.0) << " of 7" << endl;
+
+	// Assign into an existing grid, which can be one of the operands.
+	assign(a, a / 2.0 + 1.0);
+	cout << "a(6, 8) = " << a.at(6, 8) << endl;
+	assign(c, c + a);
+	cout << "c(6, 8) = " << c.at(6, 8).value_or(-1) << endl;
+
+	// Integer grids use the scalar pack.
+	DenseGrid<int> counts(5, 1);
+	assign(counts, counts + 3);
+	cout << "counts(4, 0) = " << counts.at(4, 0) << endl;
+
+	try {
+		DenseGrid<double> other(3, 3);
+		assign(a, a + other);
+	} catch (const invalid_argument& e) {
+		cout << "Caught: " << e.what() << endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+
+// Layout policies for Grid. A layout maps cell (x, y) of a width x height
+// grid to an index in the grid's buffer, and tells the grid how large
+// that buffer must be.
+//
+// Both layouts also define a tile size, which forEachTile() uses to walk
+// a grid in cache-friendly blocks.
+
+// Stores the cells row by row: cell (x, y) is at index x + y * width.
+// Rows, columns, and sub-grids are strided ranges in this layout, which
+// is why the Grid views require it.
+class RowMajorLayout
+{
+public:
+	RowMajorLayout(size_t width, size_t /*height*/) : mWidth(width) {}
+
+	size_t index(size_t x, size_t y) const { return x + y * mWidth; }
+	static size_t getBufferSize(size_t width, size_t height) { return width * height; }
+
+	static const size_t kTileWidth = 64;
+	static const size_t kTileHeight = 64;
+
+private:
+	size_t mWidth;
+};
+
+// Stores the cells in square tiles of TILE_SIZE x TILE_SIZE cells. Each
+// tile is contiguous and row-major, and the tiles themselves are stored
+// row by row. A cell and its neighbors in all four directions are then
+// usually in the same few cache lines, whereas in RowMajorLayout the
+// cells above and below are a whole row apart.
+//
+// TILE_SIZE must be a power of two, so the index computation only needs
+// shifts and masks. The grid is padded to a whole number of tiles.
+template <size_t TILE_SIZE = 64>
+class TiledLayout
+{
+	static_assert(TILE_SIZE > 0 && (TILE_SIZE & (TILE_SIZE - 1)) == 0,
+		"TILE_SIZE must be a power of two.");
+
+public:
+	TiledLayout(size_t width, size_t /*height*/) : mTilesPerRow(numTiles(width)) {}
+
+	size_t index(size_t x, size_t y) const
+	{
+		size_t tile = (y / TILE_SIZE) * mTilesPerRow + x / TILE_SIZE;
+		return tile * kCellsPerTile + (y % TILE_SIZE) * TILE_SIZE + x % TILE_SIZE;
+	}
+	static size_t getBufferSize(size_t width, size_t height)
+	{
+		return numTiles(width) * numTiles(height) * kCellsPerTile;
+	}
+
+	static const size_t kTileWidth = TILE_SIZE;
+	static const size_t kTileHeight = TILE_SIZE;
+
+private:
+	static size_t numTiles(size_t cells) { return (cells + TILE_SIZE - 1) / TILE_SIZE; }
+
+	static const size_t kCellsPerTile = TILE_SIZE * TILE_SIZE;
+
+	size_t mTilesPerRow;
+};
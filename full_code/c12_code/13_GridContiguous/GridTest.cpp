@@ -0,0 +1,59 @@
+#include "Grid.h"
+#include <algorithm>
+#include <numeric>
+#include <functional>
+#include <string>
+#include <iostream>
+
+using namespace std;
+
+int main()
+{
+	Grid<int> myGrid(4, 3);
+
+	// Number all cells, row by row, through the grid iterators.
+	int counter = 0;
+	for (auto& cell : myGrid) {
+		cell = counter++;
+	}
+
+	// A row view is contiguous, a column view is strided, but both can
+	// be used with Standard Library algorithms without copying any cells.
+	auto sumCells = [](int sum, const optional<int>& cell) { return sum + cell.value_or(0); };
+	auto row1 = myGrid.row(1);
+	cout << "Sum of row 1: " << accumulate(begin(row1), end(row1), 0, sumCells) << endl;
+	auto column2 = myGrid.column(2);
+	cout << "Sum of column 2: " << accumulate(begin(column2), end(column2), 0, sumCells) << endl;
+
+	// Sort a column in descending order, in place in the grid.
+	sort(begin(column2), end(column2), greater<>());
+	for (const auto& cell : column2) {
+		cout << cell.value_or(0) << " ";
+	}
+	cout << endl;
+
+	// Clear a 2x2 block in the middle of the grid.
+	auto block = myGrid.subGrid(1, 1, 2, 2);
+	fill(begin(block), end(block), nullopt);
+
+	for (size_t y = 0; y < myGrid.getHeight(); ++y) {
+		for (const auto& cell : myGrid.row(y)) {
+			cout << (cell ? to_string(*cell) : string("-")) << "\t";
+		}
+		cout << endl;
+	}
+
+	const Grid<int>& constGrid = myGrid;
+	auto constRow = constGrid.row(0);
+	cout << "Cells with a value in row 0: "
+		<< count_if(begin(constRow), end(constRow), [](const auto& cell) { return cell.has_value(); })
+		<< endl;
+
+	try {
+		myGrid.subGrid(3, 0, 2, 2);
+	} catch (const out_of_range&) {
+		cout << "Sub-grid out of range." << endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,228 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+
+// Random-access iterator over elements that are a fixed number of
+// elements (the stride) apart in one contiguous buffer.
+// T can be const-qualified to get a const iterator.
+//
+// The position is kept as an index from the first element, and the
+// pointer is only computed when dereferencing. An end iterator of a
+// column would otherwise point more than one past the end of the buffer,
+// which is undefined behavior even if it is never dereferenced.
+// Comparing iterators of different views is meaningless.
+template <typename T>
+class StridedIterator
+{
+public:
+	using iterator_category = std::random_access_iterator_tag;
+	using value_type = std::remove_cv_t<T>;
+	using difference_type = std::ptrdiff_t;
+	using pointer = T*;
+	using reference = T&;
+
+	StridedIterator() = default;
+	StridedIterator(T* first, difference_type index, difference_type stride)
+		: mFirst(first), mIndex(index), mStride(stride) {}
+
+	// Allows conversion from a non-const iterator to a const iterator.
+	template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+	StridedIterator(const StridedIterator<U>& other)
+		: mFirst(other.mFirst), mIndex(other.mIndex), mStride(other.mStride) {}
+
+	reference operator*() const { return mFirst[mIndex * mStride]; }
+	pointer operator->() const { return mFirst + mIndex * mStride; }
+	reference operator[](difference_type n) const { return mFirst[(mIndex + n) * mStride]; }
+
+	StridedIterator& operator++() { ++mIndex; return *this; }
+	StridedIterator operator++(int) { auto old = *this; ++*this; return old; }
+	StridedIterator& operator--() { --mIndex; return *this; }
+	StridedIterator operator--(int) { auto old = *this; --*this; return old; }
+
+	StridedIterator& operator+=(difference_type n) { mIndex += n; return *this; }
+	StridedIterator& operator-=(difference_type n) { mIndex -= n; return *this; }
+	StridedIterator operator+(difference_type n) const { auto it = *this; return it += n; }
+	StridedIterator operator-(difference_type n) const { auto it = *this; return it -= n; }
+	friend StridedIterator operator+(difference_type n, const StridedIterator& it) { return it + n; }
+	difference_type operator-(const StridedIterator& rhs) const { return mIndex - rhs.mIndex; }
+
+	bool operator==(const StridedIterator& rhs) const { return mIndex == rhs.mIndex; }
+	bool operator!=(const StridedIterator& rhs) const { return mIndex != rhs.mIndex; }
+	bool operator<(const StridedIterator& rhs) const { return mIndex < rhs.mIndex; }
+	bool operator>(const StridedIterator& rhs) const { return mIndex > rhs.mIndex; }
+	bool operator<=(const StridedIterator& rhs) const { return mIndex <= rhs.mIndex; }
+	bool operator>=(const StridedIterator& rhs) const { return mIndex >= rhs.mIndex; }
+
+private:
+	template <typename U> friend class StridedIterator;
+
+	T* mFirst = nullptr;
+	difference_type mIndex = 0;
+	difference_type mStride = 1;
+};
+
+// Non-owning view of size elements, stride elements apart.
+// A row of a row-major grid has stride 1, a column has stride width.
+// The view is only valid as long as the grid it refers to is alive
+// and is not resized.
+template <typename T>
+class StridedView
+{
+public:
+	using iterator = StridedIterator<T>;
+
+	StridedView(T* first, size_t size, size_t stride)
+		: mFirst(first), mSize(size), mStride(stride) {}
+
+	// Allows conversion from a non-const view to a const view.
+	template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+	StridedView(const StridedView<U>& other)
+		: mFirst(other.mFirst), mSize(other.mSize), mStride(other.mStride) {}
+
+	T& operator[](size_t i) const { return mFirst[i * mStride]; }
+	T& at(size_t i) const;
+
+	iterator begin() const { return iterator(mFirst, 0, mStride); }
+	iterator end() const { return iterator(mFirst, mSize, mStride); }
+
+	size_t size() const { return mSize; }
+	size_t stride() const { return mStride; }
+
+private:
+	template <typename U> friend class StridedView;
+
+	T* mFirst;
+	size_t mSize;
+	size_t mStride;
+};
+
+template <typename T>
+T& StridedView<T>::at(size_t i) const
+{
+	if (i >= mSize) {
+		throw std::out_of_range("");
+	}
+	return (*this)[i];
+}
+
+// Forward iterator visiting the cells of a rectangle in a row-major
+// buffer, row by row. pitch is the distance between two rows, i.e.,
+// the width of the underlying grid. Like StridedIterator, it keeps the
+// position as row and column, so the end iterator doesn't need a pointer
+// past the end of the buffer.
+template <typename T>
+class RectIterator
+{
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = std::remove_cv_t<T>;
+	using difference_type = std::ptrdiff_t;
+	using pointer = T*;
+	using reference = T&;
+
+	RectIterator() = default;
+	RectIterator(T* first, size_t row, size_t width, size_t pitch)
+		: mFirst(first), mRow(row), mWidth(width), mPitch(pitch) {}
+
+	reference operator*() const { return mFirst[mRow * mPitch + mColumn]; }
+	pointer operator->() const { return mFirst + mRow * mPitch + mColumn; }
+
+	RectIterator& operator++()
+	{
+		if (++mColumn == mWidth) {
+			mColumn = 0;
+			++mRow;
+		}
+		return *this;
+	}
+	RectIterator operator++(int) { auto old = *this; ++*this; return old; }
+
+	bool operator==(const RectIterator& rhs) const
+	{
+		return mRow == rhs.mRow && mColumn == rhs.mColumn;
+	}
+	bool operator!=(const RectIterator& rhs) const { return !(*this == rhs); }
+
+private:
+	T* mFirst = nullptr;
+	size_t mRow = 0;
+	size_t mColumn = 0;
+	size_t mWidth = 0;
+	size_t mPitch = 0;
+};
+
+// Non-owning view of a width x height sub-rectangle of a row-major
+// buffer with the given pitch. Iteration visits the cells row by row.
+template <typename T>
+class RectView
+{
+public:
+	using iterator = RectIterator<T>;
+
+	RectView(T* first, size_t width, size_t height, size_t pitch)
+		: mFirst(first), mWidth(width), mHeight(height), mPitch(pitch) {}
+
+	// Allows conversion from a non-const view to a const view.
+	template <typename U, typename = std::enable_if_t<std::is_convertible_v<U*, T*>>>
+	RectView(const RectView<U>& other)
+		: mFirst(other.mFirst), mWidth(other.mWidth), mHeight(other.mHeight), mPitch(other.mPitch) {}
+
+	T& at(size_t x, size_t y) const;
+
+	StridedView<T> row(size_t y) const;
+	StridedView<T> column(size_t x) const;
+	RectView<T> subGrid(size_t x, size_t y, size_t width, size_t height) const;
+
+	// An empty rectangle has begin() == end().
+	iterator begin() const { return mWidth == 0 ? end() : iterator(mFirst, 0, mWidth, mPitch); }
+	iterator end() const { return iterator(mFirst, mHeight, mWidth, mPitch); }
+
+	size_t getHeight() const { return mHeight; }
+	size_t getWidth() const { return mWidth; }
+
+private:
+	template <typename U> friend class RectView;
+
+	T* mFirst;
+	size_t mWidth, mHeight;
+	size_t mPitch;
+};
+
+template <typename T>
+T& RectView<T>::at(size_t x, size_t y) const
+{
+	if (x >= mWidth || y >= mHeight) {
+		throw std::out_of_range("");
+	}
+	return mFirst[x + y * mPitch];
+}
+
+template <typename T>
+StridedView<T> RectView<T>::row(size_t y) const
+{
+	if (y >= mHeight) {
+		throw std::out_of_range("");
+	}
+	return StridedView<T>(mFirst + y * mPitch, mWidth, 1);
+}
+
+template <typename T>
+StridedView<T> RectView<T>::column(size_t x) const
+{
+	if (x >= mWidth) {
+		throw std::out_of_range("");
+	}
+	return StridedView<T>(mFirst + x, mHeight, mPitch);
+}
+
+template <typename T>
+RectView<T> RectView<T>::subGrid(size_t x, size_t y, size_t width, size_t height) const
+{
+	if (x + width > mWidth || y + height > mHeight) {
+		throw std::out_of_range("");
+	}
+	return RectView<T>(mFirst + x + y * mPitch, width, height, mPitch);
+}
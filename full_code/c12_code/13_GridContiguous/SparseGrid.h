@@ -0,0 +1,229 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <unordered_map>
+#include <optional>
+#include <utility>
+
+// Grid for huge boards on which almost all cells are empty, such as a
+// 100000 x 100000 map with a few thousand entities. The board is divided
+// into square tiles of TILE_SIZE x TILE_SIZE cells, and only tiles with
+// at least one non-empty cell are stored, in a hash map keyed by the tile
+// index. Memory use is proportional to the number of occupied tiles, not
+// to width * height, and a tile is released as soon as its last cell is
+// reset.
+//
+// The interface follows DenseGrid: at() returns the value of a non-empty
+// cell, and set() and reset() change which cells are empty. forEachCell()
+// visits the non-empty cells only.
+//
+// TILE_SIZE must be a power of two. Small tiles waste less memory on
+// scattered cells, large tiles need fewer hash lookups for clustered ones.
+template <typename T, size_t TILE_SIZE = 16>
+class SparseGrid
+{
+	static_assert(TILE_SIZE > 0 && (TILE_SIZE & (TILE_SIZE - 1)) == 0,
+		"TILE_SIZE must be a power of two.");
+
+public:
+	explicit SparseGrid(size_t width = kDefaultWidth, size_t height = kDefaultHeight);
+	virtual ~SparseGrid() = default;
+
+	// Explicitly default a copy constructor and copy assignment operator.
+	SparseGrid(const SparseGrid& src) = default;
+	SparseGrid<T, TILE_SIZE>& operator=(const SparseGrid& rhs) = default;
+
+	// Explicitly default a move constructor and move assignment operator.
+	SparseGrid(SparseGrid&& src) = default;
+	SparseGrid<T, TILE_SIZE>& operator=(SparseGrid&& rhs) = default;
+
+	// Returns true if the cell has a value.
+	bool has(size_t x, size_t y) const;
+
+	// Returns the value of the cell.
+	// Throws bad_optional_access if the cell is empty.
+	T& at(size_t x, size_t y);
+	const T& at(size_t x, size_t y) const;
+
+	// Returns a copy of the cell, or nullopt if the cell is empty.
+	std::optional<T> get(size_t x, size_t y) const;
+
+	// Stores a value in the cell, marking it as non-empty.
+	void set(size_t x, size_t y, const T& value);
+
+	// Makes the cell empty.
+	void reset(size_t x, size_t y);
+
+	// Returns the number of non-empty cells.
+	size_t count() const;
+
+	// Returns the number of tiles currently allocated.
+	size_t getNumTiles() const { return mTiles.size(); }
+
+	// Calls func(x, y, value) for every non-empty cell. The cells of a
+	// tile are visited row by row, but the order of the tiles is
+	// unspecified. func must not call set() or reset().
+	template <typename Func>
+	void forEachCell(Func func);
+	template <typename Func>
+	void forEachCell(Func func) const;
+
+	size_t getHeight() const { return mHeight; }
+	size_t getWidth() const { return mWidth; }
+
+	static const size_t kDefaultWidth = 10;
+	static const size_t kDefaultHeight = 10;
+
+private:
+	void verifyCoordinate(size_t x, size_t y) const;
+
+	static const size_t kCellsPerTile = TILE_SIZE * TILE_SIZE;
+
+	struct Tile
+	{
+		std::array<std::optional<T>, kCellsPerTile> mCells;
+		size_t mCount = 0;
+	};
+
+	size_t tileIndex(size_t x, size_t y) const { return (y / TILE_SIZE) * mTilesPerRow + x / TILE_SIZE; }
+	static size_t cellIndex(size_t x, size_t y) { return (y % TILE_SIZE) * TILE_SIZE + x % TILE_SIZE; }
+
+	// Returns the cell, or nullptr if its tile isn't allocated.
+	const std::optional<T>* findCell(size_t x, size_t y) const;
+
+	template <typename Self, typename Func>
+	static void forEachCellImpl(Self& self, Func& func);
+
+	std::unordered_map<size_t, Tile> mTiles;
+	size_t mWidth, mHeight;
+	size_t mTilesPerRow;
+};
+
+template <typename T, size_t TILE_SIZE>
+SparseGrid<T, TILE_SIZE>::SparseGrid(size_t width, size_t height)
+	: mWidth(width)
+	, mHeight(height)
+	, mTilesPerRow((width + TILE_SIZE - 1) / TILE_SIZE)
+{
+}
+
+template <typename T, size_t TILE_SIZE>
+void SparseGrid<T, TILE_SIZE>::verifyCoordinate(size_t x, size_t y) const
+{
+	if (x >= mWidth || y >= mHeight) {
+		throw std::out_of_range("");
+	}
+}
+
+template <typename T, size_t TILE_SIZE>
+const std::optional<T>* SparseGrid<T, TILE_SIZE>::findCell(size_t x, size_t y) const
+{
+	verifyCoordinate(x, y);
+	auto iter = mTiles.find(tileIndex(x, y));
+	if (iter == std::end(mTiles)) {
+		return nullptr;
+	}
+	return &iter->second.mCells[cellIndex(x, y)];
+}
+
+template <typename T, size_t TILE_SIZE>
+bool SparseGrid<T, TILE_SIZE>::has(size_t x, size_t y) const
+{
+	const auto* cell = findCell(x, y);
+	return cell && cell->has_value();
+}
+
+template <typename T, size_t TILE_SIZE>
+const T& SparseGrid<T, TILE_SIZE>::at(size_t x, size_t y) const
+{
+	const auto* cell = findCell(x, y);
+	if (!cell) {
+		throw std::bad_optional_access();
+	}
+	return cell->value();
+}
+
+template <typename T, size_t TILE_SIZE>
+T& SparseGrid<T, TILE_SIZE>::at(size_t x, size_t y)
+{
+	return const_cast<T&>(std::as_const(*this).at(x, y));
+}
+
+template <typename T, size_t TILE_SIZE>
+std::optional<T> SparseGrid<T, TILE_SIZE>::get(size_t x, size_t y) const
+{
+	const auto* cell = findCell(x, y);
+	return cell ? *cell : std::nullopt;
+}
+
+template <typename T, size_t TILE_SIZE>
+void SparseGrid<T, TILE_SIZE>::set(size_t x, size_t y, const T& value)
+{
+	verifyCoordinate(x, y);
+	Tile& tile = mTiles[tileIndex(x, y)];
+	auto& cell = tile.mCells[cellIndex(x, y)];
+	if (!cell) {
+		++tile.mCount;
+	}
+	cell = value;
+}
+
+template <typename T, size_t TILE_SIZE>
+void SparseGrid<T, TILE_SIZE>::reset(size_t x, size_t y)
+{
+	verifyCoordinate(x, y);
+	auto iter = mTiles.find(tileIndex(x, y));
+	if (iter == std::end(mTiles)) {
+		return;
+	}
+	Tile& tile = iter->second;
+	auto& cell = tile.mCells[cellIndex(x, y)];
+	if (cell) {
+		cell.reset();
+		// Release the tile together with its last value.
+		if (--tile.mCount == 0) {
+			mTiles.erase(iter);
+		}
+	}
+}
+
+template <typename T, size_t TILE_SIZE>
+size_t SparseGrid<T, TILE_SIZE>::count() const
+{
+	size_t result = 0;
+	for (const auto& [index, tile] : mTiles) {
+		result += tile.mCount;
+	}
+	return result;
+}
+
+template <typename T, size_t TILE_SIZE>
+template <typename Self, typename Func>
+void SparseGrid<T, TILE_SIZE>::forEachCellImpl(Self& self, Func& func)
+{
+	for (auto& [index, tile] : self.mTiles) {
+		size_t firstX = (index % self.mTilesPerRow) * TILE_SIZE;
+		size_t firstY = (index / self.mTilesPerRow) * TILE_SIZE;
+		for (size_t i = 0; i < kCellsPerTile; ++i) {
+			if (tile.mCells[i]) {
+				func(firstX + i % TILE_SIZE, firstY + i / TILE_SIZE, *tile.mCells[i]);
+			}
+		}
+	}
+}
+
+template <typename T, size_t TILE_SIZE>
+template <typename Func>
+void SparseGrid<T, TILE_SIZE>::forEachCell(Func func)
+{
+	forEachCellImpl(*this, func);
+}
+
+template <typename T, size_t TILE_SIZE>
+template <typename Func>
+void SparseGrid<T, TILE_SIZE>::forEachCell(Func func) const
+{
+	forEachCellImpl(*this, func);
+}
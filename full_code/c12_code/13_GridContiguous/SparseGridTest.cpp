@@ -0,0 +1,48 @@
+#include "SparseGrid.h"
+#include <string>
+#include <iostream>
+
+using namespace std;
+
+int main()
+{
+	// A 100000 x 100000 map; only occupied tiles take memory.
+	SparseGrid<string> map(100'000, 100'000);
+
+	map.set(5, 7, "tree");
+	map.set(6, 7, "rock");
+	map.set(99'999, 99'999, "castle");
+	map.set(50'000, 20'000, "village");
+	cout << "Non-empty cells: " << map.count()
+		<< ", allocated tiles: " << map.getNumTiles() << endl;
+
+	if (map.has(5, 7)) {
+		cout << "Cell (5, 7) = " << map.at(5, 7) << endl;
+	}
+	map.at(6, 7) = "boulder";
+	cout << "Cell (6, 7) = " << map.get(6, 7).value_or("<empty>") << endl;
+	cout << "Cell (8, 8) = " << map.get(8, 8).value_or("<empty>") << endl;
+
+	// Visits the four non-empty cells only, not all 10^10 cells.
+	map.forEachCell([](size_t x, size_t y, const string& value) {
+		cout << "  (" << x << ", " << y << "): " << value << endl;
+	});
+
+	// Resetting the last cell of a tile releases the tile.
+	map.reset(99'999, 99'999);
+	cout << "Non-empty cells: " << map.count()
+		<< ", allocated tiles: " << map.getNumTiles() << endl;
+
+	try {
+		map.at(99'999, 99'999);
+	} catch (const bad_optional_access&) {
+		cout << "Cell (99999, 99999) is empty." << endl;
+	}
+	try {
+		map.set(100'000, 0, "outside");
+	} catch (const out_of_range&) {
+		cout << "Cell (100000, 0) is outside the map." << endl;
+	}
+
+	return 0;
+}
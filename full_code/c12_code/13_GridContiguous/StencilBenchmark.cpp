@@ -0,0 +1,90 @@
+#include "Grid.h"
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <string_view>
+
+using namespace std;
+using namespace std::chrono;
+
+// Applies a 5-point stencil to the cells of the given rectangle:
+// every interior cell becomes the average of itself and its four
+// neighbors. Border cells are copied.
+template <typename GridType>
+void stencil(const GridType& in, GridType& out, size_t x0, size_t y0,
+	size_t width, size_t height, bool columnByColumn)
+{
+	auto update = [&](size_t x, size_t y) {
+		if (x == 0 || y == 0 || x == in.getWidth() - 1 || y == in.getHeight() - 1) {
+			out.at(x, y) = in.at(x, y);
+			return;
+		}
+		out.at(x, y) = 0.2f * (*in.at(x, y) + *in.at(x - 1, y) + *in.at(x + 1, y)
+			+ *in.at(x, y - 1) + *in.at(x, y + 1));
+	};
+
+	if (columnByColumn) {
+		for (size_t x = x0; x < x0 + width; ++x) {
+			for (size_t y = y0; y < y0 + height; ++y) { update(x, y); }
+		}
+	} else {
+		for (size_t y = y0; y < y0 + height; ++y) {
+			for (size_t x = x0; x < x0 + width; ++x) { update(x, y); }
+		}
+	}
+}
+
+enum class Traversal { Rows, Columns, Tiles };
+
+// Runs a number of stencil iterations and returns the time per iteration.
+template <typename Layout>
+double benchmark(size_t size, int iterations, Traversal traversal)
+{
+	Grid<float, Layout> a(size, size), b(size, size);
+	for (size_t y = 0; y < size; ++y) {
+		for (size_t x = 0; x < size; ++x) {
+			a.at(x, y) = static_cast<float>((x * 7 + y * 13) % 100);
+		}
+	}
+
+	auto start = high_resolution_clock::now();
+	for (int i = 0; i < iterations; ++i) {
+		if (traversal == Traversal::Tiles) {
+			forEachTile(a, [&](size_t x, size_t y, size_t width, size_t height) {
+				stencil(a, b, x, y, width, height, false);
+			});
+		} else {
+			stencil(a, b, 0, 0, size, size, traversal == Traversal::Columns);
+		}
+		swap(a, b);
+	}
+	auto end = high_resolution_clock::now();
+
+	// Output a cell, because otherwise a compiler might optimize away the work.
+	cout << "(checksum " << a.at(size / 2, size / 2).value_or(0) << ") ";
+	return duration<double, milli>(end - start).count() / iterations;
+}
+
+template <typename Layout>
+void runAll(string_view name, size_t size, int iterations)
+{
+	for (auto [traversal, traversalName] : { pair{ Traversal::Rows, "rows" },
+		pair{ Traversal::Columns, "columns" }, pair{ Traversal::Tiles, "tiles" } }) {
+		cout << name << ", " << traversalName << ": ";
+		double ms = benchmark<Layout>(size, iterations, traversal);
+		cout << ms << "ms per iteration" << endl;
+	}
+}
+
+// Usage: StencilBenchmark [size] [iterations]
+int main(int argc, char* argv[])
+{
+	size_t size = (argc > 1 ? strtoul(argv[1], nullptr, 10) : 2048);
+	int iterations = (argc > 2 ? atoi(argv[2]) : 5);
+
+	cout << "5-point stencil on a " << size << "x" << size << " Grid<float>" << endl;
+	runAll<RowMajorLayout>("RowMajorLayout", size, iterations);
+	runAll<TiledLayout<64>>("TiledLayout<64>", size, iterations);
+
+	return 0;
+}
@@ -0,0 +1,53 @@
+#include "GameBoard.h"
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+GameBoard::GameBoard(shared_ptr<const GamePieceRegistry> registry, size_t width, size_t height)
+	: mRegistry(move(registry))
+	, mWidth(width)
+	, mHeight(height)
+{
+	if (!mRegistry) {
+		throw invalid_argument("A board needs a registry.");
+	}
+	mCells.resize(mWidth * mHeight, kNoPiece);
+}
+
+void GameBoard::verifyCoordinate(size_t x, size_t y) const
+{
+	if (x >= mWidth || y >= mHeight) {
+		throw std::out_of_range("");
+	}
+}
+
+void swap(GameBoard& first, GameBoard& second) noexcept
+{
+	using std::swap;
+
+	swap(first.mRegistry, second.mRegistry);
+	swap(first.mCells, second.mCells);
+	swap(first.mWidth, second.mWidth);
+	swap(first.mHeight, second.mHeight);
+}
+
+const PieceId& GameBoard::at(size_t x, size_t y) const
+{
+	verifyCoordinate(x, y);
+	return mCells[x + y * mWidth];
+}
+
+PieceId& GameBoard::at(size_t x, size_t y)
+{
+	return const_cast<PieceId&>(as_const(*this).at(x, y));
+}
+
+const GamePiece* GameBoard::getPiece(size_t x, size_t y) const
+{
+	PieceId id = at(x, y);
+	if (id == kNoPiece) {
+		return nullptr;
+	}
+	return &mRegistry->get(id);
+}
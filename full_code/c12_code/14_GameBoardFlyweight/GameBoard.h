@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+#include "GamePieceRegistry.h"
+
+// GameBoard whose cells store the PieceId of a piece in a shared
+// GamePieceRegistry instead of owning a piece. Copying a board copies
+// one contiguous array of small integers and never allocates pieces or
+// calls virtual functions, which makes it cheap enough to copy boards in
+// a game-tree search.
+class GameBoard
+{
+public:
+	explicit GameBoard(std::shared_ptr<const GamePieceRegistry> registry,
+		size_t width = kDefaultWidth, size_t height = kDefaultHeight);
+	virtual ~GameBoard() = default;    // virtual defaulted destructor
+
+	// Explicitly default a copy constructor and copy assignment operator.
+	// Copies share the registry.
+	GameBoard(const GameBoard& src) = default;
+	GameBoard& operator=(const GameBoard& rhs) = default;
+
+	// Explicitly default a move constructor and move assignment operator.
+	GameBoard(GameBoard&& src) = default;
+	GameBoard& operator=(GameBoard&& src) = default;
+
+	// The id of the piece in a cell, or kNoPiece if the cell is empty.
+	PieceId& at(size_t x, size_t y);
+	const PieceId& at(size_t x, size_t y) const;
+
+	// Returns the piece in a cell, or nullptr if the cell is empty.
+	// Throws out_of_range if the cell contains an unknown id.
+	const GamePiece* getPiece(size_t x, size_t y) const;
+
+	const GamePieceRegistry& getRegistry() const { return *mRegistry; }
+
+	size_t getHeight() const { return mHeight; }
+	size_t getWidth() const { return mWidth; }
+
+	static const size_t kDefaultWidth = 10;
+	static const size_t kDefaultHeight = 10;
+
+	friend void swap(GameBoard& first, GameBoard& second) noexcept;
+
+private:
+	void verifyCoordinate(size_t x, size_t y) const;
+
+	std::shared_ptr<const GamePieceRegistry> mRegistry;
+	// Cell (x, y) is stored at index x + y * mWidth.
+	std::vector<PieceId> mCells;
+	size_t mWidth, mHeight;
+};
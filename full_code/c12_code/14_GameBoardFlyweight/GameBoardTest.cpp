@@ -0,0 +1,51 @@
+#include "GameBoard.h"
+#include <iostream>
+#include <string>
+#include <utility>
+
+using namespace std;
+
+class ChessPiece : public GamePiece
+{
+public:
+	explicit ChessPiece(string name) : mName(move(name)) {}
+	virtual string getName() const override { return mName; }
+
+private:
+	string mName;
+};
+
+void processGameBoard(const GameBoard& board)
+{
+	if (const GamePiece* piece = board.getPiece(0, 0)) {
+		cout << "Piece at (0, 0): " << piece->getName() << endl;
+	}
+
+	// Doesn't compile
+	//board.at(1, 2) = kNoPiece;
+}
+
+int main()
+{
+	// Every kind of piece exists only once, in the registry.
+	auto registry = make_shared<GamePieceRegistry>();
+	PieceId whitePawn = registry->add(make_unique<ChessPiece>("white pawn"));
+	PieceId blackKing = registry->add(make_unique<ChessPiece>("black king"));
+
+	GameBoard chessBoard(registry, 8, 8);
+	for (size_t x = 0; x < chessBoard.getWidth(); ++x) {
+		chessBoard.at(x, 1) = whitePawn;
+	}
+	chessBoard.at(0, 0) = blackKing;
+	chessBoard.at(0, 1) = kNoPiece;
+
+	// Copies the cell ids only; no pieces are cloned.
+	GameBoard board2(registry);
+	board2 = chessBoard;
+	board2.at(0, 0) = whitePawn;
+
+	processGameBoard(chessBoard);
+	processGameBoard(board2);
+
+	return 0;
+}
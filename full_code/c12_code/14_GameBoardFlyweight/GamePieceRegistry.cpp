@@ -0,0 +1,26 @@
+#include "GamePieceRegistry.h"
+#include <limits>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+PieceId GamePieceRegistry::add(unique_ptr<const GamePiece> piece)
+{
+	if (!piece) {
+		throw invalid_argument("Cannot register a null piece.");
+	}
+	if (mPieces.size() >= numeric_limits<PieceId>::max()) {
+		throw length_error("Too many pieces.");
+	}
+	mPieces.push_back(move(piece));
+	return static_cast<PieceId>(mPieces.size());
+}
+
+const GamePiece& GamePieceRegistry::get(PieceId id) const
+{
+	if (id == kNoPiece || id > mPieces.size()) {
+		throw out_of_range("Unknown piece id.");
+	}
+	return *mPieces[id - 1];
+}
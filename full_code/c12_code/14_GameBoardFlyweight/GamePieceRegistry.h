@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class GamePiece
+{
+public:
+	virtual ~GamePiece() = default;
+	virtual std::string getName() const = 0;
+};
+
+// Small integer referring to a piece in a GamePieceRegistry.
+using PieceId = uint16_t;
+
+// Id of an empty cell; it never refers to a piece.
+const PieceId kNoPiece = 0;
+
+// Owns one immutable instance of every kind of piece, such as "white pawn"
+// or "black queen", and hands out a PieceId for each. Boards store only
+// these ids, so all boards share the same piece objects (flyweights).
+// Pieces are never removed, so an id stays valid as long as the registry.
+class GamePieceRegistry
+{
+public:
+	GamePieceRegistry() = default;
+
+	// Not copyable, because boards refer to it by pointer.
+	GamePieceRegistry(const GamePieceRegistry& src) = delete;
+	GamePieceRegistry& operator=(const GamePieceRegistry& rhs) = delete;
+
+	// Takes ownership of piece and returns its id.
+	// Throws invalid_argument for a null piece, and length_error if all
+	// ids are in use.
+	PieceId add(std::unique_ptr<const GamePiece> piece);
+
+	// Returns the piece with the given id.
+	// Throws out_of_range if id is kNoPiece or unknown.
+	const GamePiece& get(PieceId id) const;
+
+	// Returns the number of registered pieces.
+	size_t size() const { return mPieces.size(); }
+
+private:
+	// mPieces[i] has id i + 1, because id 0 is kNoPiece.
+	std::vector<std::unique_ptr<const GamePiece>> mPieces;
+};
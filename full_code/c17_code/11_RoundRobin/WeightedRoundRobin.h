@@ -0,0 +1,288 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <queue>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// Class template WeightedRoundRobin
+// Round-robin for a large, changing set of elements, such as the backends
+// of a load balancer, where many threads call getNext() concurrently.
+//
+// - Every element has a weight; an element of weight 3 is returned three
+//   times as often as one of weight 1. The order is smooth: the picks of
+//   a heavy element are spread out evenly over the cycle instead of
+//   coming in a burst.
+// - add() and remove() take O(1) time, using a hash map from element to
+//   position and swap-and-pop removal. Elements are unique.
+// - getNext() never locks. It reads an immutable snapshot of the elements
+//   and the pick order, and advances an atomic cursor. Changes become
+//   visible to getNext() when publish() installs a new snapshot, so a
+//   batch of changes costs one rebuild. The old snapshot is freed once no
+//   getNext() call uses it any longer (read-copy-update).
+//
+// T must be hashable with Hash and comparable with operator==. getNext()
+// returns a copy, so T should be cheap to copy, such as an address or a
+// shared_ptr.
+template <typename T, typename Hash = std::hash<T>>
+class WeightedRoundRobin
+{
+public:
+	// Client can give a hint as to the number of expected elements for
+	// increased efficiency.
+	explicit WeightedRoundRobin(size_t numExpected = 0);
+	virtual ~WeightedRoundRobin();
+
+	// Not copyable or movable, because other threads refer to it.
+	WeightedRoundRobin(const WeightedRoundRobin& src) = delete;
+	WeightedRoundRobin& operator=(const WeightedRoundRobin& rhs) = delete;
+
+	// Adds element with the given weight, or changes the weight if the
+	// element is there already.
+	// Throws invalid_argument if weight is 0.
+	void add(const T& element, uint32_t weight = 1);
+
+	// Removes element, if it is there.
+	void remove(const T& element);
+
+	bool contains(const T& element) const;
+	size_t size() const;
+
+	// Makes the changes since the previous publish() visible to getNext().
+	// The pick order has sum(weights) / gcd(weights) entries; building it
+	// takes time proportional to that length times the logarithm of the
+	// number of elements. Waits until no getNext() call uses the previous
+	// snapshot.
+	// Throws length_error if the order would have more than
+	// kMaxScheduleLength entries.
+	void publish();
+
+	// Returns the next element of the published snapshot. Can be called
+	// from any number of threads concurrently with each other and with
+	// the other member functions.
+	// Throws out_of_range if the published snapshot is empty.
+	T getNext();
+
+	static const size_t kMaxScheduleLength = size_t(1) << 24;
+
+private:
+	struct Member
+	{
+		T mElement;
+		uint32_t mWeight;
+	};
+
+	// Published state; never changed after publishing.
+	struct Snapshot
+	{
+		std::vector<T> mElements;
+		// Indices into mElements, in pick order.
+		std::vector<uint32_t> mSchedule;
+	};
+
+	static std::vector<uint32_t> buildSchedule(const std::vector<Member>& members);
+
+	// Serializes add(), remove(), and publish().
+	mutable std::mutex mMutex;
+	std::vector<Member> mMembers;
+	std::unordered_map<T, size_t, Hash> mPositions;
+
+	static const size_t kCacheLineSize = 64;
+
+	std::atomic<const Snapshot*> mSnapshot{ nullptr };
+
+	// Readers register in mReaders[epoch % 2] while they use a snapshot.
+	// publish() installs the new snapshot, advances the epoch, and waits
+	// until the readers of the old epoch are gone (the grace period).
+	alignas(kCacheLineSize) std::atomic<uint64_t> mEpoch{ 0 };
+	std::atomic<size_t> mReaders[2] = {};
+
+	// Number of picks so far; wraps around the schedule.
+	alignas(kCacheLineSize) std::atomic<size_t> mCursor{ 0 };
+};
+
+template <typename T, typename Hash>
+WeightedRoundRobin<T, Hash>::WeightedRoundRobin(size_t numExpected)
+{
+	// If the client gave a guideline, reserve that much space.
+	mMembers.reserve(numExpected);
+	mPositions.reserve(numExpected);
+}
+
+template <typename T, typename Hash>
+WeightedRoundRobin<T, Hash>::~WeightedRoundRobin()
+{
+	delete mSnapshot.load();
+}
+
+template <typename T, typename Hash>
+void WeightedRoundRobin<T, Hash>::add(const T& element, uint32_t weight)
+{
+	if (weight == 0) {
+		throw std::invalid_argument("Weight must be positive");
+	}
+	std::lock_guard lock(mMutex);
+	auto [iter, inserted] = mPositions.try_emplace(element, mMembers.size());
+	if (!inserted) {
+		mMembers[iter->second].mWeight = weight;
+		return;
+	}
+	try {
+		mMembers.push_back(Member{ element, weight });
+	} catch (...) {
+		mPositions.erase(iter);
+		throw;
+	}
+}
+
+template <typename T, typename Hash>
+void WeightedRoundRobin<T, Hash>::remove(const T& element)
+{
+	std::lock_guard lock(mMutex);
+	auto iter = mPositions.find(element);
+	if (iter == end(mPositions)) {
+		return;
+	}
+	// Move the last member into the hole, so nothing else has to move.
+	size_t position = iter->second;
+	mPositions.erase(iter);
+	if (position != mMembers.size() - 1) {
+		mMembers[position] = std::move(mMembers.back());
+		mPositions[mMembers[position].mElement] = position;
+	}
+	mMembers.pop_back();
+}
+
+template <typename T, typename Hash>
+bool WeightedRoundRobin<T, Hash>::contains(const T& element) const
+{
+	std::lock_guard lock(mMutex);
+	return mPositions.count(element) != 0;
+}
+
+template <typename T, typename Hash>
+size_t WeightedRoundRobin<T, Hash>::size() const
+{
+	std::lock_guard lock(mMutex);
+	return mMembers.size();
+}
+
+template <typename T, typename Hash>
+std::vector<uint32_t> WeightedRoundRobin<T, Hash>::buildSchedule(const std::vector<Member>& members)
+{
+	// Dividing by the common divisor gives the same order, shorter.
+	uint32_t divisor = 0;
+	for (const auto& member : members) {
+		divisor = std::gcd(divisor, member.mWeight);
+	}
+	uint64_t total = 0;
+	for (const auto& member : members) {
+		total += member.mWeight / divisor;
+	}
+	if (total > kMaxScheduleLength) {
+		throw std::length_error("Weights are too large");
+	}
+
+	// The k-th pick (k = 0, 1, ...) of a member with weight w is due at
+	// (k + 1/2) / w of the cycle, so its picks are evenly spaced. The
+	// members are picked in the order their picks are due; ties go to the
+	// member stored first. A heap holds the next due pick of every
+	// member, so each pick takes O(log(members)) time.
+	// Due times are compared as fractions (2k + 1) / 2w without rounding.
+	struct Due
+	{
+		uint64_t mNumerator;  // 2k + 1
+		uint64_t mWeight;
+		uint32_t mIndex;
+	};
+	auto later = [](const Due& lhs, const Due& rhs) {
+		uint64_t left = lhs.mNumerator * rhs.mWeight;
+		uint64_t right = rhs.mNumerator * lhs.mWeight;
+		return left != right ? left > right : lhs.mIndex > rhs.mIndex;
+	};
+	std::vector<Due> initial;
+	initial.reserve(members.size());
+	for (size_t i = 0; i < members.size(); ++i) {
+		initial.push_back(Due{ 1, members[i].mWeight / divisor, static_cast<uint32_t>(i) });
+	}
+	std::priority_queue<Due, std::vector<Due>, decltype(later)> due(later, std::move(initial));
+
+	std::vector<uint32_t> schedule;
+	schedule.reserve(total);
+	while (!due.empty()) {
+		Due next = due.top();
+		due.pop();
+		schedule.push_back(next.mIndex);
+		// A member of weight w has picks k = 0, ..., w - 1.
+		next.mNumerator += 2;
+		if (next.mNumerator < 2 * next.mWeight) {
+			due.push(next);
+		}
+	}
+	return schedule;
+}
+
+template <typename T, typename Hash>
+void WeightedRoundRobin<T, Hash>::publish()
+{
+	std::lock_guard lock(mMutex);
+	if (mMembers.size() > UINT32_MAX) {
+		throw std::length_error("Too many elements");
+	}
+	auto snapshot = std::make_unique<Snapshot>();
+	snapshot->mSchedule = buildSchedule(mMembers);
+	snapshot->mElements.reserve(mMembers.size());
+	for (const auto& member : mMembers) {
+		snapshot->mElements.push_back(member.mElement);
+	}
+
+	std::unique_ptr<const Snapshot> old(mSnapshot.exchange(snapshot.release()));
+	// Readers that registered in the old epoch may still use the old
+	// snapshot. Readers registering from now on see the new epoch, and
+	// therefore the new snapshot.
+	uint64_t epoch = mEpoch.fetch_add(1);
+	while (mReaders[epoch % 2].load() != 0) {
+		std::this_thread::yield();
+	}
+	// old is freed here.
+}
+
+template <typename T, typename Hash>
+T WeightedRoundRobin<T, Hash>::getNext()
+{
+	// Register as a reader of the current epoch. If the epoch changed in
+	// the meantime, publish() may not have waited for us; try again.
+	uint64_t epoch;
+	while (true) {
+		epoch = mEpoch.load();
+		mReaders[epoch % 2].fetch_add(1);
+		if (mEpoch.load() == epoch) {
+			break;
+		}
+		mReaders[epoch % 2].fetch_sub(1);
+	}
+
+	const Snapshot* snapshot = mSnapshot.load();
+	if (!snapshot || snapshot->mSchedule.empty()) {
+		mReaders[epoch % 2].fetch_sub(1);
+		throw std::out_of_range("No elements in the list");
+	}
+	size_t pick = mCursor.fetch_add(1, std::memory_order_relaxed) % snapshot->mSchedule.size();
+	try {
+		T result = snapshot->mElements[snapshot->mSchedule[pick]];
+		mReaders[epoch % 2].fetch_sub(1);
+		return result;
+	} catch (...) {
+		mReaders[epoch % 2].fetch_sub(1);
+		throw;
+	}
+}
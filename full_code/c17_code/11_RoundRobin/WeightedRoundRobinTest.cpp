@@ -0,0 +1,76 @@
+#include "WeightedRoundRobin.h"
+#include <atomic>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+using namespace std;
+
+int main()
+{
+	WeightedRoundRobin<string> backends;
+	backends.add("a", 5);
+	backends.add("b");
+	backends.add("c");
+	backends.publish();
+
+	// The picks of "a" are spread out over the cycle.
+	for (int i = 0; i < 7; ++i) {
+		cout << backends.getNext() << " ";
+	}
+	cout << endl;
+
+	// Changes are only visible to getNext() after publish().
+	backends.remove("a");
+	cout << "Before publish(): " << backends.getNext() << endl;
+	backends.publish();
+	for (int i = 0; i < 4; ++i) {
+		cout << backends.getNext() << " ";
+	}
+	cout << endl;
+
+	// Thousands of backends that come and go, while other threads keep
+	// picking backends.
+	WeightedRoundRobin<int> servers(1000);
+	for (int i = 0; i < 1000; ++i) {
+		servers.add(i, 1 + i % 3);
+	}
+	servers.publish();
+
+	atomic<bool> done = false;
+	atomic<size_t> numPicks = 0;
+	vector<thread> readers;
+	for (int t = 0; t < 4; ++t) {
+		readers.emplace_back([&] {
+			size_t picks = 0;
+			while (!done) {
+				servers.getNext();
+				++picks;
+			}
+			numPicks += picks;
+		});
+	}
+	for (int round = 0; round < 20; ++round) {
+		for (int i = round * 50; i < (round + 1) * 50; ++i) {
+			servers.remove(i);
+			servers.add(1000 + i, 2);
+		}
+		servers.publish();
+	}
+	done = true;
+	for (auto& reader : readers) {
+		reader.join();
+	}
+	cout << "Servers: " << servers.size() << ", picks during updates: "
+		<< (numPicks > 0 ? "yes" : "no") << endl;
+
+	// Every server is picked in proportion to its weight.
+	map<int, int> counts;
+	for (int i = 0; i < 4000; ++i) {
+		++counts[servers.getNext()];
+	}
+	cout << "Picks of server 1000 (weight 2): " << counts[1000] << endl;
+
+	return 0;
+}
@@ -0,0 +1,162 @@
+#include "EnrollmentEngine.h"
+#include <algorithm>
+#include <atomic>
+#include <fstream>
+#include <functional>
+#include <future>
+#include <iterator>
+#include <stdexcept>
+#include <thread>
+
+using namespace std;
+
+size_t ConcurrentStringSet::shardIndex(const string& str)
+{
+	// Use high bits, the unordered_set of the shard uses the low ones.
+	return (hash<string>{}(str) >> 20) % kNumShards;
+}
+
+void ConcurrentStringSet::insertAll(vector<string>&& names)
+{
+	vector<string> byShard[kNumShards];
+	for (auto& name : names) {
+		byShard[shardIndex(name)].push_back(move(name));
+	}
+	for (size_t i = 0; i < kNumShards; ++i) {
+		if (byShard[i].empty()) {
+			continue;
+		}
+		lock_guard lock(mShards[i].mMutex);
+		for (auto& name : byShard[i]) {
+			mShards[i].mStrings.insert(move(name));
+		}
+	}
+}
+
+vector<string> ConcurrentStringSet::extract()
+{
+	size_t total = 0;
+	for (auto& shard : mShards) {
+		total += shard.mStrings.size();
+	}
+	vector<string> result;
+	result.reserve(total);
+	for (auto& shard : mShards) {
+		// Move the nodes' strings out instead of copying them.
+		while (!shard.mStrings.empty()) {
+			result.push_back(move(shard.mStrings.extract(cbegin(shard.mStrings)).value()));
+		}
+	}
+	return result;
+}
+
+EnrollmentEngine::EnrollmentEngine(size_t numThreads)
+	: mNumThreads(numThreads != 0 ? numThreads : max(1u, thread::hardware_concurrency()))
+{
+}
+
+vector<string> EnrollmentEngine::readStudentList(const filesystem::path& file)
+{
+	ifstream istr(file);
+	if (!istr) {
+		throw runtime_error("Failed to open " + file.string());
+	}
+	vector<string> students;
+	string name;
+	while (getline(istr, name)) {
+		if (!name.empty() && name.back() == '\r') {
+			name.pop_back();
+		}
+		if (!name.empty()) {
+			students.push_back(move(name));
+		}
+	}
+	return students;
+}
+
+vector<filesystem::path> EnrollmentEngine::findCourseFiles(const filesystem::path& directory)
+{
+	vector<filesystem::path> files;
+	for (int i = 1;; i++) {
+		auto file = directory / ("course" + to_string(i) + ".txt");
+		if (!filesystem::exists(file)) {
+			break;
+		}
+		files.push_back(move(file));
+	}
+	return files;
+}
+
+template <typename GetCourse>
+vector<string> EnrollmentEngine::collect(size_t numCourses, GetCourse getCourse,
+	const unordered_set<string>& dropped) const
+{
+	ConcurrentStringSet students;
+	// Workers take the next course until none are left, so a few large
+	// courses don't leave the other workers idle.
+	atomic<size_t> nextCourse = 0;
+	auto work = [&] {
+		try {
+			for (size_t i = nextCourse++; i < numCourses; i = nextCourse++) {
+				vector<string> names = getCourse(i);
+				names.erase(remove_if(begin(names), end(names),
+					[&](const string& name) { return dropped.count(name) != 0; }), end(names));
+				students.insertAll(move(names));
+			}
+		} catch (...) {
+			// Make the other workers stop early.
+			nextCourse = numCourses;
+			throw;
+		}
+	};
+
+	size_t numTasks = min(mNumThreads, numCourses);
+	vector<future<void>> futures;
+	for (size_t task = 1; task < numTasks; ++task) {
+		futures.push_back(async(launch::async, work));
+	}
+	// The calling thread works too. Wait for all tasks before rethrowing
+	// an exception, because they use the local variables.
+	exception_ptr error;
+	try {
+		work();
+	} catch (...) {
+		error = current_exception();
+	}
+	for (auto& future : futures) {
+		try {
+			future.get();
+		} catch (...) {
+			if (!error) {
+				error = current_exception();
+			}
+		}
+	}
+	if (error) {
+		rethrow_exception(error);
+	}
+
+	vector<string> result = students.extract();
+	sort(begin(result), end(result));
+	return result;
+}
+
+vector<string> EnrollmentEngine::getTotalEnrollment(
+	const vector<filesystem::path>& courseFiles,
+	const filesystem::path& droppedFile) const
+{
+	auto droppedList = readStudentList(droppedFile);
+	unordered_set<string> dropped(make_move_iterator(begin(droppedList)),
+		make_move_iterator(end(droppedList)));
+	return collect(courseFiles.size(),
+		[&](size_t i) { return readStudentList(courseFiles[i]); }, dropped);
+}
+
+vector<string> EnrollmentEngine::getTotalEnrollment(
+	const vector<vector<string>>& courseStudents,
+	const vector<string>& droppedStudents) const
+{
+	unordered_set<string> dropped(cbegin(droppedStudents), cend(droppedStudents));
+	return collect(courseStudents.size(),
+		[&](size_t i) { return courseStudents[i]; }, dropped);
+}
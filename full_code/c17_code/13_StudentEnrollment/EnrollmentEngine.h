@@ -0,0 +1,79 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+// Set of strings that many threads can insert into at the same time. The
+// strings are spread over kNumShards hash sets by their hash, each with
+// its own mutex, so threads rarely wait for each other.
+class ConcurrentStringSet final
+{
+public:
+	// Inserts all names, locking every shard at most once.
+	void insertAll(std::vector<std::string>&& names);
+
+	// Moves all strings out of the set, in unspecified order, and leaves
+	// the set empty. Don't call it while other threads insert.
+	std::vector<std::string> extract();
+
+private:
+	static const size_t kNumShards = 64;
+
+	struct alignas(64) Shard
+	{
+		std::mutex mMutex;
+		std::unordered_set<std::string> mStrings;
+	};
+
+	static size_t shardIndex(const std::string& str);
+
+	Shard mShards[kNumShards];
+};
+
+// Computes the total enrollment of a large number of courses, such as the
+// 20000 course files of a registrar batch. The course files are read by
+// several threads in parallel. Every name is looked up in a hash set of
+// dropped students and, if not dropped, inserted into a
+// ConcurrentStringSet, which takes care of students in multiple courses.
+// Every name is handled once, without sorting or removing from a list.
+class EnrollmentEngine final
+{
+public:
+	// numThreads = 0 uses one thread per processor core.
+	explicit EnrollmentEngine(size_t numThreads = 0);
+
+	// Returns every enrolled (non-dropped) student in all the courses,
+	// once, sorted by name. The files have one student name per line.
+	// Throws runtime_error if a file can't be opened.
+	std::vector<std::string> getTotalEnrollment(
+		const std::vector<std::filesystem::path>& courseFiles,
+		const std::filesystem::path& droppedFile) const;
+
+	// Same, for course lists that are in memory already.
+	std::vector<std::string> getTotalEnrollment(
+		const std::vector<std::vector<std::string>>& courseStudents,
+		const std::vector<std::string>& droppedStudents) const;
+
+	// Returns course1.txt, course2.txt, ... in directory, up to the first
+	// number for which there is no file.
+	static std::vector<std::filesystem::path> findCourseFiles(
+		const std::filesystem::path& directory = ".");
+
+	// Reads one name per line, ignoring empty lines and a '\r' at the end
+	// of a line, so files with Windows line endings work everywhere.
+	// Throws runtime_error if the file can't be opened.
+	static std::vector<std::string> readStudentList(const std::filesystem::path& file);
+
+private:
+	// Calls getCourse(i) for every course i in [0, numCourses) on the
+	// worker threads, and collects the non-dropped students.
+	template <typename GetCourse>
+	std::vector<std::string> collect(size_t numCourses, GetCourse getCourse,
+		const std::unordered_set<std::string>& dropped) const;
+
+	size_t mNumThreads;
+};
@@ -0,0 +1,41 @@
+#include "EnrollmentEngine.h"
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+int main()
+{
+	EnrollmentEngine engine;
+
+	// The course files in this directory.
+	auto courseFiles = EnrollmentEngine::findCourseFiles();
+	cout << "Found " << courseFiles.size() << " course files" << endl;
+	for (const auto& name : engine.getTotalEnrollment(courseFiles, "dropped.txt")) {
+		cout << name << endl;
+	}
+
+	// A large batch in memory: 20000 courses of 30 students each, from
+	// 100000 students, of whom every tenth is dropped.
+	vector<vector<string>> courses(20000);
+	for (size_t course = 0; course < courses.size(); ++course) {
+		for (size_t i = 0; i < 30; ++i) {
+			courses[course].push_back("student" + to_string((course * 7919 + i * 104729) % 100000));
+		}
+	}
+	vector<string> dropped;
+	for (size_t student = 0; student < 100000; student += 10) {
+		dropped.push_back("student" + to_string(student));
+	}
+	auto enrolled = engine.getTotalEnrollment(courses, dropped);
+	cout << "Enrolled students: " << enrolled.size() << endl;
+
+	try {
+		engine.getTotalEnrollment({ "missing.txt" }, "dropped.txt");
+	} catch (const runtime_error& caughtException) {
+		cout << caughtException.what() << endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,359 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+// Bounded packet buffers for handing packets from one thread to another,
+// such as from a network interface thread to worker threads. Both are
+// ring buffers of a fixed capacity, allocated once, that never lock and
+// never allocate while packets flow. Packets are moved in and out.
+//
+// SpscPacketBuffer allows exactly one producer thread and one consumer
+// thread at a time; every operation finishes in a bounded number of
+// steps (wait-free).
+// MpmcPacketBuffer allows any number of producers and consumers; an
+// operation can retry when it races with another thread (lock-free). It
+// requires a packet type with a move constructor that doesn't throw.
+//
+// Like PacketBuffer, bufferPacket() drops a packet when the buffer is
+// full and returns false.
+
+// Counters written by different threads are kept in separate cache lines,
+// so the threads don't invalidate each other's caches (false sharing).
+const size_t kCacheLineSize = 64;
+
+// Returns the smallest power of two >= value, so ring indices can wrap
+// with a mask instead of a division.
+// Throws invalid_argument if value is 0.
+inline size_t roundUpToPowerOfTwo(size_t value)
+{
+	if (value == 0) {
+		throw std::invalid_argument("Capacity must be positive.");
+	}
+	size_t result = 1;
+	while (result < value) {
+		result <<= 1;
+	}
+	return result;
+}
+
+// Uninitialized storage for one packet. The buffers construct packets in
+// it when they are buffered and destroy them when they are taken out, so
+// T needs no default constructor.
+template <typename T>
+class PacketSlot
+{
+public:
+	template <typename U>
+	void construct(U&& packet) { new (mStorage) T(std::forward<U>(packet)); }
+	void destroy() { get().~T(); }
+	T& get() { return *std::launder(reinterpret_cast<T*>(mStorage)); }
+
+private:
+	alignas(T) unsigned char mStorage[sizeof(T)];
+};
+
+template <typename T>
+class SpscPacketBuffer
+{
+public:
+	// The capacity is rounded up to a power of two.
+	// Throws invalid_argument if capacity is 0.
+	explicit SpscPacketBuffer(size_t capacity);
+	virtual ~SpscPacketBuffer();
+
+	// Not copyable or movable, because other threads refer to the buffer.
+	SpscPacketBuffer(const SpscPacketBuffer& src) = delete;
+	SpscPacketBuffer& operator=(const SpscPacketBuffer& rhs) = delete;
+
+	// Stores a packet in the buffer. Only call from the producer thread.
+	// Returns false if the packet has been discarded because
+	// there is no more space in the buffer, true otherwise.
+	bool bufferPacket(T&& packet) { return push(std::move(packet)); }
+	bool bufferPacket(const T& packet) { return push(packet); }
+
+	// Moves the next packet into packet. Only call from the consumer thread.
+	// Returns false, leaving packet unchanged, if the buffer is empty.
+	bool tryGetNextPacket(T& packet);
+
+	// Moves up to maxPackets packets to out, and returns how many.
+	// Only call from the consumer thread.
+	template <typename OutputIt>
+	size_t drain(OutputIt out, size_t maxPackets);
+
+	size_t getCapacity() const { return mMask + 1; }
+
+private:
+	template <typename U>
+	bool push(U&& packet);
+
+	const size_t mMask;
+	const std::unique_ptr<PacketSlot<T>[]> mSlots;
+
+	// mHead is the number of packets taken out so far, and mTail the
+	// number of packets buffered so far; both only grow. Each is written
+	// by one thread only. The cached copies of the other thread's counter
+	// avoid touching its cache line until the buffer looks full or empty.
+	alignas(kCacheLineSize) std::atomic<size_t> mHead{ 0 };
+	size_t mCachedTail = 0;
+	alignas(kCacheLineSize) std::atomic<size_t> mTail{ 0 };
+	size_t mCachedHead = 0;
+};
+
+template <typename T>
+SpscPacketBuffer<T>::SpscPacketBuffer(size_t capacity)
+	: mMask(roundUpToPowerOfTwo(capacity) - 1)
+	, mSlots(std::make_unique<PacketSlot<T>[]>(mMask + 1))
+{
+}
+
+template <typename T>
+SpscPacketBuffer<T>::~SpscPacketBuffer()
+{
+	for (size_t i = mHead.load(); i != mTail.load(); ++i) {
+		mSlots[i & mMask].destroy();
+	}
+}
+
+template <typename T>
+template <typename U>
+bool SpscPacketBuffer<T>::push(U&& packet)
+{
+	const size_t tail = mTail.load(std::memory_order_relaxed);
+	if (tail - mCachedHead > mMask) {
+		mCachedHead = mHead.load(std::memory_order_acquire);
+		if (tail - mCachedHead > mMask) {
+			// No more space. Drop the packet.
+			return false;
+		}
+	}
+	mSlots[tail & mMask].construct(std::forward<U>(packet));
+	// Publish the packet to the consumer.
+	mTail.store(tail + 1, std::memory_order_release);
+	return true;
+}
+
+template <typename T>
+bool SpscPacketBuffer<T>::tryGetNextPacket(T& packet)
+{
+	return drain(&packet, 1) == 1;
+}
+
+template <typename T>
+template <typename OutputIt>
+size_t SpscPacketBuffer<T>::drain(OutputIt out, size_t maxPackets)
+{
+	const size_t head = mHead.load(std::memory_order_relaxed);
+	if (mCachedTail - head < maxPackets) {
+		mCachedTail = mTail.load(std::memory_order_acquire);
+	}
+	const size_t count = std::min(mCachedTail - head, maxPackets);
+	size_t i = head;
+	try {
+		for (; i != head + count; ++i) {
+			auto& slot = mSlots[i & mMask];
+			*out = std::move(slot.get());
+			++out;
+			slot.destroy();
+		}
+	} catch (...) {
+		// Drop the packet that couldn't be stored, and release the slots
+		// consumed so far.
+		mSlots[i & mMask].destroy();
+		mHead.store(i + 1, std::memory_order_release);
+		throw;
+	}
+	// Hand all slots back to the producer at once.
+	mHead.store(head + count, std::memory_order_release);
+	return count;
+}
+
+template <typename T>
+class MpmcPacketBuffer
+{
+	static_assert(std::is_nothrow_move_constructible_v<T>,
+		"MpmcPacketBuffer needs a packet type with a non-throwing move constructor.");
+
+public:
+	// The capacity is rounded up to a power of two, and at least 2.
+	// Throws invalid_argument if capacity is 0.
+	explicit MpmcPacketBuffer(size_t capacity);
+	virtual ~MpmcPacketBuffer();
+
+	// Not copyable or movable, because other threads refer to the buffer.
+	MpmcPacketBuffer(const MpmcPacketBuffer& src) = delete;
+	MpmcPacketBuffer& operator=(const MpmcPacketBuffer& rhs) = delete;
+
+	// Stores a packet in the buffer.
+	// Returns false if the packet has been discarded because
+	// there is no more space in the buffer, true otherwise.
+	bool bufferPacket(T&& packet) { return push(std::move(packet)); }
+	bool bufferPacket(const T& packet) { return push(packet); }
+
+	// Moves the next packet into packet.
+	// Returns false, leaving packet unchanged, if the buffer is empty.
+	bool tryGetNextPacket(T& packet);
+
+	// Moves up to maxPackets packets to out, and returns how many.
+	// Packets buffered concurrently by other threads may or may not be
+	// included.
+	template <typename OutputIt>
+	size_t drain(OutputIt out, size_t maxPackets);
+
+	size_t getCapacity() const { return mMask + 1; }
+
+private:
+	template <typename U>
+	bool push(U&& packet);
+
+	// Claims a free cell and constructs the packet in it. Constructing T
+	// from a U&& must not throw: once a cell is claimed, consumers wait
+	// until it is published.
+	template <typename U>
+	bool pushNoThrow(U&& packet);
+
+	// Claims the next packet and calls consume(packet) with an rvalue
+	// reference to it. Returns false if the buffer is empty.
+	template <typename Func>
+	bool pop(Func consume);
+
+	// Every cell has a sequence number telling its state for the current
+	// lap around the ring: for position pos, a cell with sequence pos is
+	// free for the producer claiming pos, and a cell with sequence pos + 1
+	// holds the packet for the consumer claiming pos.
+	struct Cell
+	{
+		std::atomic<size_t> mSequence;
+		PacketSlot<T> mSlot;
+	};
+
+	const size_t mMask;
+	const std::unique_ptr<Cell[]> mCells;
+
+	// Next positions to consume and to produce. Threads claim a position
+	// with a compare-and-swap.
+	alignas(kCacheLineSize) std::atomic<size_t> mHead{ 0 };
+	alignas(kCacheLineSize) std::atomic<size_t> mTail{ 0 };
+};
+
+template <typename T>
+MpmcPacketBuffer<T>::MpmcPacketBuffer(size_t capacity)
+	: mMask(std::max<size_t>(2, roundUpToPowerOfTwo(capacity)) - 1)
+	, mCells(std::make_unique<Cell[]>(mMask + 1))
+{
+	for (size_t i = 0; i <= mMask; ++i) {
+		mCells[i].mSequence.store(i, std::memory_order_relaxed);
+	}
+}
+
+template <typename T>
+MpmcPacketBuffer<T>::~MpmcPacketBuffer()
+{
+	for (size_t i = mHead.load(); i != mTail.load(); ++i) {
+		mCells[i & mMask].mSlot.destroy();
+	}
+}
+
+template <typename T>
+template <typename U>
+bool MpmcPacketBuffer<T>::push(U&& packet)
+{
+	if constexpr (std::is_nothrow_constructible_v<T, U&&>) {
+		return pushNoThrow(std::forward<U>(packet));
+	} else {
+		// Copy the packet before claiming a cell, so a throwing copy
+		// constructor leaves the buffer untouched.
+		T copy(std::forward<U>(packet));
+		return pushNoThrow(std::move(copy));
+	}
+}
+
+template <typename T>
+template <typename U>
+bool MpmcPacketBuffer<T>::pushNoThrow(U&& packet)
+{
+	static_assert(std::is_nothrow_constructible_v<T, U&&>);
+	size_t pos = mTail.load(std::memory_order_relaxed);
+	while (true) {
+		Cell& cell = mCells[pos & mMask];
+		size_t sequence = cell.mSequence.load(std::memory_order_acquire);
+		auto diff = static_cast<std::ptrdiff_t>(sequence - pos);
+		if (diff == 0) {
+			// The cell is free; try to claim position pos.
+			if (mTail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+				cell.mSlot.construct(std::forward<U>(packet));
+				cell.mSequence.store(pos + 1, std::memory_order_release);
+				return true;
+			}
+			// Another producer claimed it; pos now holds the new tail.
+		} else if (diff < 0) {
+			// The cell still holds a packet from the previous lap.
+			// No more space. Drop the packet.
+			return false;
+		} else {
+			pos = mTail.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+template <typename T>
+template <typename Func>
+bool MpmcPacketBuffer<T>::pop(Func consume)
+{
+	size_t pos = mHead.load(std::memory_order_relaxed);
+	while (true) {
+		Cell& cell = mCells[pos & mMask];
+		size_t sequence = cell.mSequence.load(std::memory_order_acquire);
+		auto diff = static_cast<std::ptrdiff_t>(sequence - (pos + 1));
+		if (diff == 0) {
+			// The cell holds a packet; try to claim position pos.
+			if (mHead.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+				break;
+			}
+		} else if (diff < 0) {
+			// The buffer is empty.
+			return false;
+		} else {
+			pos = mHead.load(std::memory_order_relaxed);
+		}
+	}
+
+	Cell& cell = mCells[pos & mMask];
+	auto release = [&] {
+		cell.mSlot.destroy();
+		// Free the cell for the producer of the next lap.
+		cell.mSequence.store(pos + mMask + 1, std::memory_order_release);
+	};
+	try {
+		consume(std::move(cell.mSlot.get()));
+	} catch (...) {
+		// Drop the packet, but don't leave the cell claimed forever.
+		release();
+		throw;
+	}
+	release();
+	return true;
+}
+
+template <typename T>
+bool MpmcPacketBuffer<T>::tryGetNextPacket(T& packet)
+{
+	return pop([&](T&& next) { packet = std::move(next); });
+}
+
+template <typename T>
+template <typename OutputIt>
+size_t MpmcPacketBuffer<T>::drain(OutputIt out, size_t maxPackets)
+{
+	size_t count = 0;
+	while (count < maxPackets && pop([&](T&& next) { *out = std::move(next); ++out; })) {
+		++count;
+	}
+	return count;
+}
@@ -0,0 +1,147 @@
+#include "ConcurrentPacketBuffer.h"
+#include <chrono>
+#include <iostream>
+#include <iterator>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+class IPPacket final
+{
+public:
+	IPPacket(int id) : mID(id) {}
+	int getID() const { return mID; }
+
+private:
+	int mID;
+};
+
+// Packet whose copy constructor throws for negative IDs, like a packet
+// that fails to allocate its payload. Moving never throws.
+class PayloadPacket final
+{
+public:
+	explicit PayloadPacket(int id) : mID(id) {}
+	PayloadPacket(const PayloadPacket& src) : mID(src.mID)
+	{
+		if (mID < 0) {
+			throw runtime_error("Copy failed.");
+		}
+	}
+	PayloadPacket(PayloadPacket&& src) noexcept = default;
+	PayloadPacket& operator=(PayloadPacket&& rhs) noexcept = default;
+	int getID() const { return mID; }
+
+private:
+	int mID;
+};
+
+const int kNumPackets = 5'000'000;
+
+// Producer retrying dropped packets, so every packet arrives.
+template <typename Buffer>
+void produce(Buffer& buffer, int first, int last)
+{
+	for (int i = first; i < last; ++i) {
+		IPPacket packet(i);
+		while (!buffer.bufferPacket(move(packet))) {
+			this_thread::yield();
+		}
+	}
+}
+
+// Consumer draining packets in batches until all consumers together have
+// received kNumPackets packets. Returns the sum of the IDs it received.
+template <typename Buffer>
+long long consume(Buffer& buffer, atomic<int>& consumed)
+{
+	long long sum = 0;
+	vector<IPPacket> batch;
+	batch.reserve(256);
+	while (consumed < kNumPackets) {
+		batch.clear();
+		size_t count = buffer.drain(back_inserter(batch), 256);
+		if (count == 0) {
+			this_thread::yield();
+			continue;
+		}
+		for (const auto& packet : batch) {
+			sum += packet.getID();
+		}
+		consumed += static_cast<int>(count);
+	}
+	return sum;
+}
+
+template <typename Buffer>
+void runTest(const char* name, Buffer& buffer, int numProducers, int numConsumers)
+{
+	auto start = chrono::steady_clock::now();
+	atomic<int> consumed{ 0 };
+	vector<long long> sums(numConsumers);
+	vector<thread> threads;
+	for (int i = 0; i < numProducers; ++i) {
+		threads.emplace_back([&, i] {
+			produce(buffer, kNumPackets / numProducers * i, kNumPackets / numProducers * (i + 1));
+		});
+	}
+	for (int i = 0; i < numConsumers; ++i) {
+		threads.emplace_back([&, i] { sums[i] = consume(buffer, consumed); });
+	}
+	for (auto& t : threads) {
+		t.join();
+	}
+	chrono::duration<double> seconds = chrono::steady_clock::now() - start;
+
+	long long sum = 0;
+	for (auto s : sums) {
+		sum += s;
+	}
+	long long expected = static_cast<long long>(kNumPackets) * (kNumPackets - 1) / 2;
+	cout << name << ": " << (sum == expected ? "all packets arrived" : "PACKETS LOST")
+		<< ", " << kNumPackets / seconds.count() / 1e6 << " million packets/s" << endl;
+}
+
+int main()
+{
+	SpscPacketBuffer<IPPacket> spsc(3);
+	cout << "Capacity: " << spsc.getCapacity() << endl;
+
+	// Add 5 packets
+	for (int i = 1; i <= 5; ++i) {
+		if (!spsc.bufferPacket(IPPacket(i))) {
+			cout << "Packet " << i << " dropped (queue is full)." << endl;
+		}
+	}
+	IPPacket packet(0);
+	while (spsc.tryGetNextPacket(packet)) {
+		cout << "Processing packet " << packet.getID() << endl;
+	}
+	cout << "Queue is empty." << endl;
+
+	// A packet that fails to copy is not buffered, and doesn't block the
+	// packets after it.
+	MpmcPacketBuffer<PayloadPacket> mpmc(4);
+	const PayloadPacket broken(-1);
+	try {
+		mpmc.bufferPacket(broken);
+	} catch (const runtime_error& e) {
+		cout << "Caught: " << e.what() << endl;
+	}
+	const PayloadPacket valid(7);
+	mpmc.bufferPacket(valid);
+	PayloadPacket received(0);
+	while (mpmc.tryGetNextPacket(received)) {
+		cout << "Processing packet " << received.getID() << endl;
+	}
+
+	SpscPacketBuffer<IPPacket> spscBuffer(4096);
+	runTest("SPSC, 1 producer, 1 consumer", spscBuffer, 1, 1);
+
+	MpmcPacketBuffer<IPPacket> mpmcBuffer(4096);
+	runTest("MPMC, 2 producers, 2 consumers", mpmcBuffer, 2, 2);
+
+	return 0;
+}
@@ -1,9 +1,16 @@
 #pragma once
 
+#include <chrono>
+#include <condition_variable>
 #include <cstddef>
+#include <mutex>
+#include <optional>
 #include <queue>
 #include <stdexcept>
+#include <utility>
 
+// All member functions are thread-safe, so one thread can buffer packets
+// while others wait for them with waitForNextPacket().
 template <typename T>
 class PacketBuffer
 {
@@ -19,14 +26,35 @@ public:
 	// Returns false if the packet has been discarded because
 	// there is no more space in the buffer, true otherwise.
 	bool bufferPacket(const T& packet);
+	bool bufferPacket(T&& packet);
 
 	// Returns the next packet. Throws out_of_range
 	// if the buffer is empty.
 	T getNextPacket();
 
+	// Returns the next packet, or nullopt if the buffer is empty.
+	// Doesn't throw for an empty buffer, so it's cheap to call in a
+	// polling loop.
+	std::optional<T> tryGetNextPacket();
+
+	// Returns the next packet, blocking the calling thread until a
+	// packet is buffered or timeout has passed. Returns nullopt on
+	// timeout. The thread sleeps while waiting instead of spinning.
+	template <typename Rep, typename Period>
+	std::optional<T> waitForNextPacket(const std::chrono::duration<Rep, Period>& timeout);
+
 private:
+	template <typename U>
+	bool push(U&& packet);
+
+	// Removes and returns the head element. mMutex must be locked, and
+	// the buffer must not be empty.
+	T pop();
+
 	std::queue<T> mPackets;
 	size_t mMaxSize;
+	std::mutex mMutex;
+	std::condition_variable mPacketAvailable;
 };
 
 template <typename T>
@@ -38,25 +66,72 @@ PacketBuffer<T>::PacketBuffer(size_t maxSize/* = 0 */)
 template <typename T>
 bool PacketBuffer<T>::bufferPacket(const T& packet)
 {
-	if (mMaxSize > 0 && mPackets.size() == mMaxSize) {
-		// No more space. Drop the packet.
-		return false;
-	}
+	return push(packet);
+}
 
-	mPackets.push(packet);
-	return true;
+template <typename T>
+bool PacketBuffer<T>::bufferPacket(T&& packet)
+{
+	return push(std::move(packet));
 }
 
 template <typename T>
-T PacketBuffer<T>::getNextPacket()
+template <typename U>
+bool PacketBuffer<T>::push(U&& packet)
 {
-	if (mPackets.empty()) {
-		throw std::out_of_range("Buffer is empty");
+	{
+		std::lock_guard lock(mMutex);
+		if (mMaxSize > 0 && mPackets.size() == mMaxSize) {
+			// No more space. Drop the packet.
+			return false;
+		}
+
+		mPackets.push(std::forward<U>(packet));
 	}
-	// Retrieve the head element
-	T temp = mPackets.front();
+	// Notify after unlocking, so the woken thread doesn't block on the mutex.
+	mPacketAvailable.notify_one();
+	return true;
+}
+
+template <typename T>
+T PacketBuffer<T>::pop()
+{
+	// Move the head element out instead of copying it
+	T temp = std::move(mPackets.front());
 	// Pop the head element
 	mPackets.pop();
 	// Return the head element
 	return temp;
 }
+
+template <typename T>
+T PacketBuffer<T>::getNextPacket()
+{
+	std::lock_guard lock(mMutex);
+	if (mPackets.empty()) {
+		throw std::out_of_range("Buffer is empty");
+	}
+	return pop();
+}
+
+template <typename T>
+std::optional<T> PacketBuffer<T>::tryGetNextPacket()
+{
+	std::lock_guard lock(mMutex);
+	if (mPackets.empty()) {
+		return std::nullopt;
+	}
+	return pop();
+}
+
+template <typename T>
+template <typename Rep, typename Period>
+std::optional<T> PacketBuffer<T>::waitForNextPacket(
+	const std::chrono::duration<Rep, Period>& timeout)
+{
+	std::unique_lock lock(mMutex);
+	if (!mPacketAvailable.wait_for(lock, timeout, [this] { return !mPackets.empty(); })) {
+		return std::nullopt;
+	}
+	return pop();
+}
@@ -1,5 +1,7 @@
 #include "PacketBuffer.h"
+#include <chrono>
 #include <iostream>
+#include <thread>
 
 using namespace std;
 
@@ -33,5 +35,25 @@ int main()
 			break;
 		}
 	}
+
+	// Polling without exceptions.
+	ipPackets.bufferPacket(IPPacket(5));
+	while (auto packet = ipPackets.tryGetNextPacket()) {
+		cout << "Processing packet " << packet->getID() << endl;
+	}
+
+	// A consumer thread sleeps until packets arrive.
+	thread consumer([&ipPackets] {
+		while (auto packet = ipPackets.waitForNextPacket(chrono::milliseconds(500))) {
+			cout << "Consumer processing packet " << packet->getID() << endl;
+		}
+		cout << "No packet for 500 ms." << endl;
+	});
+	for (int i = 6; i <= 8; ++i) {
+		this_thread::sleep_for(chrono::milliseconds(50));
+		ipPackets.bufferPacket(IPPacket(i));
+	}
+	consumer.join();
+
 	return 0;
 }
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+#include "ConcurrentPacketBuffer.h"
+
+class PacketSlab;
+
+// Reference to a payload stored in a PacketSlab: the slab, the slot, and
+// the payload length. Handles are what travels through a packet buffer,
+// so buffering a packet copies a few words, never the payload bytes.
+//
+// Handles are reference counted like shared_ptr: copying a handle shares
+// the payload, and the slot is recycled when the last handle to it is
+// destroyed or reset. A default-constructed handle refers to nothing.
+class PacketHandle
+{
+public:
+	PacketHandle() = default;
+	~PacketHandle() { reset(); }
+
+	PacketHandle(const PacketHandle& src);
+	PacketHandle& operator=(const PacketHandle& rhs);
+	PacketHandle(PacketHandle&& src) noexcept;
+	PacketHandle& operator=(PacketHandle&& rhs) noexcept;
+
+	// Releases the payload, recycling its slot if this was the last handle.
+	void reset() noexcept;
+
+	explicit operator bool() const { return mSlab != nullptr; }
+
+	// The payload bytes. Only the producer should write them, before the
+	// handle is buffered.
+	std::byte* data() const;
+	size_t size() const { return mLength; }
+
+	// Position of the payload in the slab's buffer, in bytes.
+	size_t getOffset() const;
+
+	friend void swap(PacketHandle& first, PacketHandle& second) noexcept;
+
+private:
+	friend class PacketSlab;
+	PacketHandle(PacketSlab* slab, uint32_t slot, uint32_t length)
+		: mSlab(slab), mSlot(slot), mLength(length) {}
+
+	PacketSlab* mSlab = nullptr;
+	uint32_t mSlot = 0;
+	uint32_t mLength = 0;
+};
+
+// Allocator for packet payloads of at most slotSize bytes. All payloads
+// live in one buffer allocated up front, which could for example be
+// registered with a network card for DMA. The buffer is divided into
+// numSlots slots of slotSize bytes. Free slots are kept in an
+// MpmcPacketBuffer, so producers can allocate and consumers release
+// concurrently without locking.
+//
+// The slab must outlive all handles to its payloads.
+class PacketSlab
+{
+public:
+	// Throws invalid_argument if slotSize or numSlots is 0 or larger than
+	// UINT32_MAX, or if the buffer size slotSize * numSlots overflows.
+	PacketSlab(size_t slotSize, size_t numSlots);
+	virtual ~PacketSlab() = default;
+
+	// Not copyable or movable, because handles refer to the slab.
+	PacketSlab(const PacketSlab& src) = delete;
+	PacketSlab& operator=(const PacketSlab& rhs) = delete;
+
+	// Returns a handle to a payload of length bytes, with a reference
+	// count of 1. The bytes are uninitialized. Returns an empty handle if
+	// all slots are in use.
+	// Throws length_error if length is larger than the slot size.
+	PacketHandle allocate(size_t length);
+
+	size_t getSlotSize() const { return mSlotSize; }
+	size_t getNumSlots() const { return mNumSlots; }
+
+	// Returns the number of slots currently not in use. Only a snapshot
+	// while other threads allocate or release slots.
+	size_t getNumFreeSlots() const { return mNumFree.load(std::memory_order_relaxed); }
+
+private:
+	friend class PacketHandle;
+
+	// Returns numSlots, or throws invalid_argument. Called from the member
+	// initializers, before anything is allocated.
+	static size_t verifyDimensions(size_t slotSize, size_t numSlots);
+
+	void addReference(uint32_t slot) { mReferences[slot].fetch_add(1, std::memory_order_relaxed); }
+	void release(uint32_t slot);
+	std::byte* getSlotData(uint32_t slot) const { return mBuffer.get() + slot * mSlotSize; }
+
+	const size_t mSlotSize;
+	const size_t mNumSlots;
+	const std::unique_ptr<std::byte[]> mBuffer;
+	const std::unique_ptr<std::atomic<uint32_t>[]> mReferences;
+	MpmcPacketBuffer<uint32_t> mFreeSlots;
+	std::atomic<size_t> mNumFree;
+};
+
+inline PacketSlab::PacketSlab(size_t slotSize, size_t numSlots)
+	: mSlotSize(slotSize)
+	, mNumSlots(verifyDimensions(slotSize, numSlots))
+	, mBuffer(std::make_unique<std::byte[]>(slotSize * numSlots))
+	, mReferences(std::make_unique<std::atomic<uint32_t>[]>(numSlots))
+	, mFreeSlots(numSlots)
+	, mNumFree(numSlots)
+{
+	for (size_t slot = 0; slot < numSlots; ++slot) {
+		mFreeSlots.bufferPacket(static_cast<uint32_t>(slot));
+	}
+}
+
+inline size_t PacketSlab::verifyDimensions(size_t slotSize, size_t numSlots)
+{
+	if (slotSize == 0 || slotSize > UINT32_MAX || numSlots == 0 || numSlots > UINT32_MAX ||
+		// Can only overflow where size_t has 32 bits.
+		slotSize > SIZE_MAX / numSlots) {
+		throw std::invalid_argument("Invalid slab dimensions.");
+	}
+	return numSlots;
+}
+
+inline PacketHandle PacketSlab::allocate(size_t length)
+{
+	if (length > mSlotSize) {
+		throw std::length_error("Payload doesn't fit in a slot.");
+	}
+	uint32_t slot;
+	if (!mFreeSlots.tryGetNextPacket(slot)) {
+		return PacketHandle();
+	}
+	mNumFree.fetch_sub(1, std::memory_order_relaxed);
+	mReferences[slot].store(1, std::memory_order_relaxed);
+	return PacketHandle(this, slot, static_cast<uint32_t>(length));
+}
+
+inline void PacketSlab::release(uint32_t slot)
+{
+	// acq_rel makes all writes to the payload through other handles
+	// visible before the slot is reused.
+	if (mReferences[slot].fetch_sub(1, std::memory_order_acq_rel) == 1) {
+		mNumFree.fetch_add(1, std::memory_order_relaxed);
+		// Can't fail: the free list has room for every slot.
+		mFreeSlots.bufferPacket(slot);
+	}
+}
+
+inline PacketHandle::PacketHandle(const PacketHandle& src)
+	: mSlab(src.mSlab), mSlot(src.mSlot), mLength(src.mLength)
+{
+	if (mSlab) {
+		mSlab->addReference(mSlot);
+	}
+}
+
+inline PacketHandle& PacketHandle::operator=(const PacketHandle& rhs)
+{
+	// Copy-and-swap idiom
+	PacketHandle temp(rhs);
+	swap(*this, temp);
+	return *this;
+}
+
+inline PacketHandle::PacketHandle(PacketHandle&& src) noexcept
+{
+	swap(*this, src);
+}
+
+inline PacketHandle& PacketHandle::operator=(PacketHandle&& rhs) noexcept
+{
+	PacketHandle temp(std::move(rhs));
+	swap(*this, temp);
+	return *this;
+}
+
+inline void PacketHandle::reset() noexcept
+{
+	if (mSlab) {
+		mSlab->release(mSlot);
+		mSlab = nullptr;
+		mSlot = mLength = 0;
+	}
+}
+
+inline std::byte* PacketHandle::data() const
+{
+	return mSlab ? mSlab->getSlotData(mSlot) : nullptr;
+}
+
+inline size_t PacketHandle::getOffset() const
+{
+	return mSlab ? mSlot * mSlab->getSlotSize() : 0;
+}
+
+inline void swap(PacketHandle& first, PacketHandle& second) noexcept
+{
+	using std::swap;
+
+	swap(first.mSlab, second.mSlab);
+	swap(first.mSlot, second.mSlot);
+	swap(first.mLength, second.mLength);
+}
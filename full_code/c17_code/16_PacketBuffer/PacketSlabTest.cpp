@@ -0,0 +1,86 @@
+#include "PacketSlab.h"
+#include "PacketBuffer.h"
+#include "ConcurrentPacketBuffer.h"
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+const int kNumPackets = 1'000'000;
+
+int main()
+{
+	// 64 slots of 1500 bytes, one Ethernet frame each.
+	PacketSlab slab(1500, 64);
+
+	// Handles work with the original PacketBuffer too; copying a handle
+	// into the buffer shares the payload instead of copying it.
+	PacketBuffer<PacketHandle> buffer(3);
+	{
+		PacketHandle packet = slab.allocate(5);
+		memcpy(packet.data(), "hello", 5);
+		buffer.bufferPacket(packet);
+		cout << "Free slots while buffered: " << slab.getNumFreeSlots() << endl;
+	}
+	PacketHandle received = buffer.getNextPacket();
+	cout << "Received " << string(reinterpret_cast<const char*>(received.data()), received.size())
+		<< " at offset " << received.getOffset() << endl;
+	received.reset();
+	cout << "Free slots after release: " << slab.getNumFreeSlots() << endl;
+
+	// A producer thread fills payloads in place and hands them to a
+	// consumer thread through a lock-free buffer. The consumer reads the
+	// bytes where the producer wrote them; dropping the handle recycles
+	// the slot for the producer.
+	SpscPacketBuffer<PacketHandle> handoff(32);
+	thread producer([&] {
+		for (int i = 0; i < kNumPackets; ++i) {
+			PacketHandle packet;
+			while (!(packet = slab.allocate(sizeof(int)))) {
+				this_thread::yield();   // All slots are in flight.
+			}
+			memcpy(packet.data(), &i, sizeof(int));
+			while (!handoff.bufferPacket(move(packet))) {
+				this_thread::yield();
+			}
+		}
+	});
+
+	long long sum = 0;
+	for (int count = 0; count < kNumPackets;) {
+		PacketHandle packet;
+		if (!handoff.tryGetNextPacket(packet)) {
+			this_thread::yield();
+			continue;
+		}
+		int value;
+		memcpy(&value, packet.data(), sizeof(int));
+		sum += value;
+		++count;
+	}
+	producer.join();
+
+	long long expected = static_cast<long long>(kNumPackets) * (kNumPackets - 1) / 2;
+	cout << (sum == expected ? "All payloads arrived" : "PAYLOADS LOST")
+		<< ", free slots: " << slab.getNumFreeSlots() << " of " << slab.getNumSlots() << endl;
+
+	// Invalid dimensions are rejected before anything is allocated.
+	const size_t kInvalidDimensions[][2] = {
+		{ 0, 64 }, { 1500, 0 }, { 1500, size_t(UINT32_MAX) + 1 }
+	};
+	for (const auto& dimensions : kInvalidDimensions) {
+		try {
+			PacketSlab invalid(dimensions[0], dimensions[1]);
+			cout << "NOT REJECTED: " << dimensions[0] << " x " << dimensions[1] << endl;
+		} catch (const invalid_argument& caughtException) {
+			cout << "Rejected " << dimensions[0] << " x " << dimensions[1]
+				<< ": " << caughtException.what() << endl;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,74 @@
+#include "BoundedErrorCorrelator.h"
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+
+using namespace std;
+
+size_t BoundedErrorCorrelator::KeyHash::operator()(const Key& key) const
+{
+	return hash<string_view>{}(key.mErrorString) ^ hash<int>{}(key.mPriority);
+}
+
+BoundedErrorCorrelator::BoundedErrorCorrelator(size_t k, size_t sketchWidth, size_t sketchDepth)
+	: mK(k)
+	, mCounts(sketchWidth, sketchDepth)
+{
+	if (k == 0) {
+		throw invalid_argument("k must be positive.");
+	}
+	mHeap.reserve(k);
+	mRetained.reserve(k);
+}
+
+void BoundedErrorCorrelator::addError(int priority, string_view errorString)
+{
+	mCounts.add(errorString);
+
+	if (mRetained.count(Key{ priority, errorString }) > 0) {
+		// Already retained; the sketch has counted it.
+		return;
+	}
+	if (mHeap.size() == mK) {
+		if (priority <= mHeap.front()->getPriority()) {
+			// Not among the k highest priorities.
+			return;
+		}
+		// Evict the lowest-priority retained error.
+		pop_heap(begin(mHeap), end(mHeap), higherPriority);
+		const Error& evicted = *mHeap.back();
+		mRetained.erase(Key{ evicted.getPriority(), evicted.getErrorString() });
+		mHeap.pop_back();
+	}
+
+	auto added = make_unique<Error>(priority, errorString);
+	mRetained.insert(Key{ priority, added->getErrorString() });
+	mHeap.push_back(move(added));
+	push_heap(begin(mHeap), end(mHeap), higherPriority);
+}
+
+void BoundedErrorCorrelator::addError(const Error& error)
+{
+	addError(error.getPriority(), error.getErrorString());
+}
+
+vector<pair<Error, uint64_t>> BoundedErrorCorrelator::getTopErrors() const
+{
+	vector<pair<Error, uint64_t>> result;
+	result.reserve(mHeap.size());
+	for (const auto& error : mHeap) {
+		result.emplace_back(*error, mCounts.estimate(error->getErrorString()));
+	}
+	stable_sort(begin(result), end(result), [](const auto& lhs, const auto& rhs) {
+		return lhs.first.getPriority() > rhs.first.getPriority();
+	});
+	return result;
+}
+
+void BoundedErrorCorrelator::reset()
+{
+	mRetained.clear();
+	mHeap.clear();
+	mCounts.clear();
+}
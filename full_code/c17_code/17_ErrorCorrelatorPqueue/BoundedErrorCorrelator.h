@@ -0,0 +1,70 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+#include "CountMinSketch.h"
+#include "ErrorCorrelator.h"
+
+// ErrorCorrelator for error floods that uses constant memory: it keeps
+// only the k highest-priority distinct errors, and counts all errors,
+// retained or not, approximately in a CountMinSketch keyed by error
+// string. Adding an error takes O(log k) time.
+//
+// Call reset() at the end of every reporting window.
+class BoundedErrorCorrelator final
+{
+public:
+	// Throws invalid_argument if k, sketchWidth, or sketchDepth is 0.
+	explicit BoundedErrorCorrelator(size_t k, size_t sketchWidth = 4096, size_t sketchDepth = 4);
+
+	// Add an error to be correlated.
+	void addError(int priority, std::string_view errorString);
+	void addError(const Error& error);
+
+	// Returns the retained errors, highest priority first, each with the
+	// estimated number of times its string has been added.
+	std::vector<std::pair<Error, uint64_t>> getTopErrors() const;
+
+	// Returns the estimated number of times errorString has been added,
+	// whether or not it's among the retained errors.
+	uint64_t estimateCount(std::string_view errorString) const { return mCounts.estimate(errorString); }
+
+	// Returns the total number of errors added.
+	uint64_t getTotalCount() const { return mCounts.getTotal(); }
+
+	// Forgets all errors and counts.
+	void reset();
+
+private:
+	// The string_view refers to the string of a retained Error, which
+	// doesn't move because it's allocated separately.
+	struct Key
+	{
+		int mPriority;
+		std::string_view mErrorString;
+		bool operator==(const Key& rhs) const
+		{
+			return mPriority == rhs.mPriority && mErrorString == rhs.mErrorString;
+		}
+	};
+	struct KeyHash
+	{
+		size_t operator()(const Key& key) const;
+	};
+
+	// Orders the heap so its front is the lowest-priority retained error.
+	static bool higherPriority(const std::unique_ptr<Error>& lhs, const std::unique_ptr<Error>& rhs)
+	{
+		return lhs->getPriority() > rhs->getPriority();
+	}
+
+	size_t mK;
+	std::vector<std::unique_ptr<Error>> mHeap;
+	std::unordered_set<Key, KeyHash> mRetained;
+	CountMinSketch mCounts;
+};
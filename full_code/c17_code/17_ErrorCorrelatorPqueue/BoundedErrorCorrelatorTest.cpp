@@ -0,0 +1,32 @@
+#include "BoundedErrorCorrelator.h"
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+int main()
+{
+	// Keep the 3 highest-priority errors of a flood of 1000 distinct
+	// errors, reported 1000 times each.
+	BoundedErrorCorrelator ec(3);
+	for (int round = 0; round < 1000; ++round) {
+		for (int priority = 1; priority <= 1000; ++priority) {
+			ec.addError(priority, "Error " + to_string(priority));
+		}
+	}
+	ec.addError(Error(1, "Incorrect entry from user"));
+
+	for (const auto& [error, count] : ec.getTopErrors()) {
+		cout << error << ", about " << count << " times" << endl;
+	}
+	cout << "\"Error 42\" occurred about " << ec.estimateCount("Error 42") << " times" << endl;
+	cout << "\"Incorrect entry from user\" occurred about "
+		<< ec.estimateCount("Incorrect entry from user") << " times" << endl;
+	cout << "Total errors: " << ec.getTotalCount() << endl;
+
+	// Start the next window.
+	ec.reset();
+	cout << "Retained after reset: " << ec.getTopErrors().size() << endl;
+
+	return 0;
+}
@@ -0,0 +1,157 @@
+#include "ConcurrentErrorCorrelator.h"
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <utility>
+
+using namespace std;
+
+bool operator<(const CoalescedError& lhs, const CoalescedError& rhs)
+{
+	if (lhs.getError().getPriority() != rhs.getError().getPriority()) {
+		return lhs.getError().getPriority() < rhs.getError().getPriority();
+	}
+	return lhs.getFirstSeen() > rhs.getFirstSeen();
+}
+
+ostream& operator<<(ostream& os, const CoalescedError& err)
+{
+	os << err.getError() << " x" << err.getCount();
+	return os;
+}
+
+bool CoalescedError::coalesce(size_t count, Clock::time_point firstSeen, Clock::time_point lastSeen,
+	Clock::duration window)
+{
+	if (firstSeen - mFirstSeen > window) {
+		return false;
+	}
+	mCount += count;
+	mLastSeen = max(mLastSeen, lastSeen);
+	return true;
+}
+
+size_t ErrorKeyHash::operator()(const ErrorKey& key) const
+{
+	return hash<string_view>{}(key.mErrorString) ^ hash<int>{}(key.mPriority);
+}
+
+void ErrorCoalescer::add(int priority, string_view errorString, size_t count,
+	CoalescedError::Clock::time_point firstSeen, CoalescedError::Clock::time_point lastSeen)
+{
+	auto iter = mLatest.find(ErrorKey{ priority, errorString });
+	if (iter != end(mLatest)) {
+		if (mErrors[iter->second].coalesce(count, firstSeen, lastSeen, mWindow)) {
+			return;
+		}
+		// The window has passed; the key will refer to the new error.
+		mLatest.erase(iter);
+	}
+
+	mErrors.emplace_back(Error(priority, errorString), count, firstSeen, lastSeen);
+	mLatest.emplace(ErrorKey{ priority, mErrors.back().getError().getErrorString() }, mErrors.size() - 1);
+}
+
+void ErrorCoalescer::add(const CoalescedError& error)
+{
+	add(error.getError().getPriority(), error.getError().getErrorString(),
+		error.getCount(), error.getFirstSeen(), error.getLastSeen());
+}
+
+vector<CoalescedError> ErrorCoalescer::takeAll()
+{
+	vector<CoalescedError> result(make_move_iterator(begin(mErrors)), make_move_iterator(end(mErrors)));
+	mLatest.clear();
+	mErrors.clear();
+	return result;
+}
+
+ConcurrentErrorCorrelator::ConcurrentErrorCorrelator(Clock::duration window)
+	: mWindow(window)
+{
+	// Twice as many stages as cores, so threads seldom share a stage.
+	size_t numStages = 2 * max(1u, thread::hardware_concurrency());
+	for (size_t i = 0; i < numStages; ++i) {
+		mStages.push_back(make_unique<Stage>(window));
+	}
+}
+
+ConcurrentErrorCorrelator::Stage& ConcurrentErrorCorrelator::getStage()
+{
+	return *mStages[hash<thread::id>{}(this_thread::get_id()) % mStages.size()];
+}
+
+void ConcurrentErrorCorrelator::addError(int priority, string_view errorString)
+{
+	auto now = Clock::now();
+	Stage& stage = getStage();
+	lock_guard lock(stage.mMutex);
+	stage.mErrors.add(priority, errorString, 1, now, now);
+}
+
+void ConcurrentErrorCorrelator::addError(const Error& error)
+{
+	addError(error.getPriority(), error.getErrorString());
+}
+
+// Orders the heap of pending errors by the errors the iterators refer to.
+const auto kHeapOrder = [](const auto& lhs, const auto& rhs) { return *lhs < *rhs; };
+
+void ConcurrentErrorCorrelator::addPending(CoalescedError&& error)
+{
+	const Error& newError = error.getError();
+	auto iter = mLatestPending.find(ErrorKey{ newError.getPriority(), newError.getErrorString() });
+	if (iter != end(mLatestPending)) {
+		if (iter->second->coalesce(error.getCount(), error.getFirstSeen(), error.getLastSeen(), mWindow)) {
+			return;
+		}
+		// The window has passed; the key will refer to the new error.
+		mLatestPending.erase(iter);
+	}
+
+	auto pending = mPending.insert(end(mPending), move(error));
+	const Error& stored = pending->getError();
+	mLatestPending.emplace(ErrorKey{ stored.getPriority(), stored.getErrorString() }, pending);
+	mHeap.push_back(pending);
+	push_heap(begin(mHeap), end(mHeap), kHeapOrder);
+}
+
+vector<CoalescedError> ConcurrentErrorCorrelator::drainTop(size_t n)
+{
+	lock_guard heapLock(mHeapMutex);
+
+	// Collect the staging buffers, and coalesce duplicates reported by
+	// different threads, or still pending from earlier calls, in the order
+	// they were first seen.
+	vector<CoalescedError> staged;
+	for (auto& stage : mStages) {
+		lock_guard stageLock(stage->mMutex);
+		auto errors = stage->mErrors.takeAll();
+		move(begin(errors), end(errors), back_inserter(staged));
+	}
+	stable_sort(begin(staged), end(staged), [](const auto& lhs, const auto& rhs) {
+		return lhs.getFirstSeen() < rhs.getFirstSeen();
+	});
+	for (auto& error : staged) {
+		addPending(move(error));
+	}
+
+	// Move the errors out of the heap instead of copying their strings.
+	vector<CoalescedError> result;
+	while (result.size() < n && !mHeap.empty()) {
+		pop_heap(begin(mHeap), end(mHeap), kHeapOrder);
+		auto top = mHeap.back();
+		mHeap.pop_back();
+		// Later duplicates start a new entry.
+		const Error& error = top->getError();
+		auto latest = mLatestPending.find(ErrorKey{ error.getPriority(), error.getErrorString() });
+		if (latest != end(mLatestPending) && latest->second == top) {
+			mLatestPending.erase(latest);
+		}
+		result.push_back(move(*top));
+		mPending.erase(top);
+	}
+	return result;
+}
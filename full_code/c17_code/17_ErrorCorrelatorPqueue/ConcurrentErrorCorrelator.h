@@ -0,0 +1,144 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <deque>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include "ErrorCorrelator.h"
+
+// An error that occurred count times between firstSeen and lastSeen.
+class CoalescedError final
+{
+public:
+	using Clock = std::chrono::steady_clock;
+
+	CoalescedError(const Error& error, size_t count, Clock::time_point firstSeen, Clock::time_point lastSeen)
+		: mError(error), mCount(count), mFirstSeen(firstSeen), mLastSeen(lastSeen) {}
+
+	const Error& getError() const { return mError; }
+	size_t getCount() const { return mCount; }
+	Clock::time_point getFirstSeen() const { return mFirstSeen; }
+	Clock::time_point getLastSeen() const { return mLastSeen; }
+
+	// Adds count later occurrences of the same error, and returns true, if
+	// they were first seen within window of this error. Returns false,
+	// leaving this error unchanged, otherwise.
+	bool coalesce(size_t count, Clock::time_point firstSeen, Clock::time_point lastSeen,
+		Clock::duration window);
+
+private:
+
+	Error mError;
+	size_t mCount;
+	Clock::time_point mFirstSeen;
+	Clock::time_point mLastSeen;
+};
+
+// Higher priority first; for equal priorities, the error first seen
+// earliest comes first.
+bool operator<(const CoalescedError& lhs, const CoalescedError& rhs);
+std::ostream& operator<<(std::ostream& os, const CoalescedError& err);
+
+// Identifies duplicates: errors with the same priority and string. The
+// string_view refers to the string of a stored error, or to the caller's
+// string while looking up a new error.
+struct ErrorKey
+{
+	int mPriority;
+	std::string_view mErrorString;
+	bool operator==(const ErrorKey& rhs) const
+	{
+		return mPriority == rhs.mPriority && mErrorString == rhs.mErrorString;
+	}
+};
+
+struct ErrorKeyHash
+{
+	size_t operator()(const ErrorKey& key) const;
+};
+
+// Collects errors, merging errors with the same priority and string into
+// one CoalescedError as long as they occur within window of the first
+// occurrence. Looking up a duplicate doesn't copy its string.
+// Not thread-safe.
+class ErrorCoalescer final
+{
+public:
+	explicit ErrorCoalescer(CoalescedError::Clock::duration window) : mWindow(window) {}
+
+	void add(int priority, std::string_view errorString, size_t count,
+		CoalescedError::Clock::time_point firstSeen, CoalescedError::Clock::time_point lastSeen);
+	void add(const CoalescedError& error);
+
+	// Returns all collected errors in the order they were first added,
+	// and empties the coalescer.
+	std::vector<CoalescedError> takeAll();
+
+private:
+	CoalescedError::Clock::duration mWindow;
+	// A deque, because its elements don't move when new ones are added.
+	std::deque<CoalescedError> mErrors;
+	// Index in mErrors of the latest error for every key.
+	std::unordered_map<ErrorKey, size_t, ErrorKeyHash> mLatest;
+};
+
+// Thread-safe ErrorCorrelator for error storms, when many threads report
+// the same errors over and over again. Duplicates within the coalescing
+// window are reported once, with a count.
+//
+// addError() only touches a staging buffer chosen by the calling thread's
+// ID, so threads reporting errors rarely contend with each other.
+// drainTop() merges all staging buffers into a shared heap, coalescing
+// duplicates reported by different threads, and with errors left in the
+// heap by earlier calls, and returns the highest-priority errors.
+class ConcurrentErrorCorrelator final
+{
+public:
+	using Clock = CoalescedError::Clock;
+
+	explicit ConcurrentErrorCorrelator(Clock::duration window = std::chrono::seconds(1));
+
+	// Add an error to be correlated. Reporting a duplicate of an error in
+	// the same window doesn't allocate memory.
+	void addError(int priority, std::string_view errorString);
+	void addError(const Error& error);
+
+	// Retrieves up to n errors, highest priority first. Returns fewer if
+	// not enough errors are left.
+	std::vector<CoalescedError> drainTop(size_t n);
+
+private:
+	struct alignas(64) Stage
+	{
+		explicit Stage(Clock::duration window) : mErrors(window) {}
+		std::mutex mMutex;
+		ErrorCoalescer mErrors;
+	};
+
+	using PendingList = std::list<CoalescedError>;
+
+	Stage& getStage();
+
+	// Coalesces error with the latest pending duplicate, or adds it to the
+	// heap. Call with mHeapMutex locked.
+	void addPending(CoalescedError&& error);
+
+	Clock::duration mWindow;
+	std::vector<std::unique_ptr<Stage>> mStages;
+
+	std::mutex mHeapMutex;
+	// Errors not drained yet. A list, because its elements don't move
+	// when others are added or removed.
+	PendingList mPending;
+	// Heap of the pending errors, highest priority on top. Coalescing only
+	// changes the count and last-seen time of an error, which don't
+	// affect its place in the heap.
+	std::vector<PendingList::iterator> mHeap;
+	// The latest pending error for every key.
+	std::unordered_map<ErrorKey, PendingList::iterator, ErrorKeyHash> mLatestPending;
+};
@@ -0,0 +1,60 @@
+#include "ConcurrentErrorCorrelator.h"
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+int main()
+{
+	ConcurrentErrorCorrelator ec(chrono::seconds(10));
+
+	// Four threads report the same errors over and over again.
+	vector<thread> threads;
+	for (int t = 0; t < 4; ++t) {
+		threads.emplace_back([&ec] {
+			for (int i = 0; i < 100'000; ++i) {
+				ec.addError(3, "Unable to read file");
+				if (i % 1000 == 0) {
+					ec.addError(10, "Unable to allocate memory!");
+				}
+			}
+		});
+	}
+	for (auto& t : threads) {
+		t.join();
+	}
+	ec.addError(Error(1, "Incorrect entry from user"));
+
+	// All duplicates are coalesced into three entries.
+	for (const auto& error : ec.drainTop(2)) {
+		cout << error << endl;
+	}
+	cout << "Remaining:" << endl;
+	for (const auto& error : ec.drainTop(10)) {
+		cout << error << endl;
+	}
+	cout << "Finished processing errors" << endl;
+
+	// Errors left in the heap by a drainTop() still absorb later duplicates.
+	ConcurrentErrorCorrelator pending(chrono::seconds(10));
+	pending.addError(5, "Disk almost full");
+	pending.drainTop(0);
+	pending.addError(5, "Disk almost full");
+	for (const auto& error : pending.drainTop(10)) {
+		cout << error << endl;
+	}
+
+	// Duplicates outside the window are reported separately.
+	ConcurrentErrorCorrelator shortWindow(chrono::milliseconds(10));
+	shortWindow.addError(3, "Unable to read file");
+	this_thread::sleep_for(chrono::milliseconds(20));
+	shortWindow.addError(3, "Unable to read file");
+	shortWindow.addError(3, "Unable to read file");
+	for (const auto& error : shortWindow.drainTop(10)) {
+		cout << error << endl;
+	}
+
+	return 0;
+}
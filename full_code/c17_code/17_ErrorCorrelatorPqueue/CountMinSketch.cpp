@@ -0,0 +1,62 @@
+#include "CountMinSketch.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+CountMinSketch::CountMinSketch(size_t width, size_t depth)
+	: mWidth(width)
+	, mDepth(depth)
+{
+	if (width == 0 || depth == 0) {
+		throw invalid_argument("Width and depth must be positive.");
+	}
+	mCounters.resize(width * depth);
+}
+
+size_t CountMinSketch::secondHash(size_t hash)
+{
+	// Mix the bits of the first hash (a 64-bit finalizer), and make the
+	// result odd so it never degenerates to a step of 0.
+	uint64_t x = hash;
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdULL;
+	x ^= x >> 33;
+	return static_cast<size_t>(x | 1);
+}
+
+size_t CountMinSketch::getIndex(size_t hash1, size_t hash2, size_t row) const
+{
+	// Derive one hash per row from two hashes (Kirsch-Mitzenmacher), so
+	// the key is only hashed once.
+	return row * mWidth + (hash1 + row * hash2) % mWidth;
+}
+
+void CountMinSketch::add(string_view key, uint64_t count)
+{
+	size_t hash1 = hash<string_view>{}(key);
+	size_t hash2 = secondHash(hash1);
+	for (size_t row = 0; row < mDepth; ++row) {
+		mCounters[getIndex(hash1, hash2, row)] += count;
+	}
+	mTotal += count;
+}
+
+uint64_t CountMinSketch::estimate(string_view key) const
+{
+	size_t hash1 = hash<string_view>{}(key);
+	size_t hash2 = secondHash(hash1);
+	uint64_t result = numeric_limits<uint64_t>::max();
+	for (size_t row = 0; row < mDepth; ++row) {
+		result = min(result, mCounters[getIndex(hash1, hash2, row)]);
+	}
+	return result;
+}
+
+void CountMinSketch::clear()
+{
+	fill(begin(mCounters), end(mCounters), 0);
+	mTotal = 0;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Approximate counts of strings in a fixed amount of memory: depth rows
+// of width counters. Adding a string increments one counter per row; the
+// estimate is the smallest of those counters. Collisions can only make
+// counts too high, never too low, and with N additions in total, an
+// estimate is at most about e * N / width too high, with a probability
+// that decreases exponentially with depth.
+class CountMinSketch final
+{
+public:
+	// Throws invalid_argument if width or depth is 0.
+	CountMinSketch(size_t width, size_t depth);
+
+	void add(std::string_view key, uint64_t count = 1);
+	uint64_t estimate(std::string_view key) const;
+
+	// Returns the total of all counts added.
+	uint64_t getTotal() const { return mTotal; }
+
+	// Resets all counts to 0.
+	void clear();
+
+	size_t getWidth() const { return mWidth; }
+	size_t getDepth() const { return mDepth; }
+
+private:
+	// Returns the index in mCounters of the counter for key in row.
+	size_t getIndex(size_t hash1, size_t hash2, size_t row) const;
+	static size_t secondHash(size_t hash);
+
+	size_t mWidth, mDepth;
+	std::vector<uint64_t> mCounters;
+	uint64_t mTotal = 0;
+};
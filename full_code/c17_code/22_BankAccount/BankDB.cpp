@@ -4,6 +4,105 @@
 
 using namespace std;
 
+BankAccount& BankAccount::operator=(const BankAccount& rhs)
+{
+	// Stays in the same database, if any, under the new name.
+	setAcctNum(rhs.mAcctNum);
+	setClientName(rhs.mClientName);
+	return *this;
+}
+
+void BankAccount::setAcctNum(int acctNum)
+{
+	if (mDatabase && acctNum != mAcctNum) {
+		throw invalid_argument("Can't change the number of an account in a database.");
+	}
+	mAcctNum = acctNum;
+}
+
+void BankAccount::setClientName(string_view name)
+{
+	string newName(name);
+	if (mDatabase) {
+		mDatabase->renameAccount(mAcctNum, mClientName, newName);
+	}
+	mClientName = move(newName);
+}
+
+BankDB::BankDB(const BankDB& src)
+	: mAccounts(src.mAccounts)
+	, mNameIndex(src.mNameIndex)
+{
+	adoptAccounts();
+}
+
+BankDB& BankDB::operator=(const BankDB& rhs)
+{
+	// Copy-and-swap idiom
+	BankDB temp(rhs);
+	swap(*this, temp);
+	return *this;
+}
+
+BankDB::BankDB(BankDB&& src) noexcept
+{
+	swap(*this, src);
+}
+
+BankDB& BankDB::operator=(BankDB&& rhs) noexcept
+{
+	BankDB temp(std::move(rhs));
+	swap(*this, temp);
+	return *this;
+}
+
+void swap(BankDB& first, BankDB& second) noexcept
+{
+	using std::swap;
+
+	swap(first.mAccounts, second.mAccounts);
+	swap(first.mNameIndex, second.mNameIndex);
+	first.adoptAccounts();
+	second.adoptAccounts();
+}
+
+void BankDB::adoptAccounts()
+{
+	for (auto& [acctNum, account] : mAccounts) {
+		account.mDatabase = this;
+	}
+}
+
+void BankDB::indexAccount(int acctNum, string_view name)
+{
+	auto it = mNameIndex.find(name);
+	if (it == end(mNameIndex)) {
+		it = mNameIndex.emplace(name, set<int>()).first;
+	}
+	it->second.insert(acctNum);
+}
+
+void BankDB::unindexAccount(int acctNum, string_view name)
+{
+	auto it = mNameIndex.find(name);
+	if (it != end(mNameIndex)) {
+		it->second.erase(acctNum);
+		// Don't keep names without accounts.
+		if (it->second.empty()) {
+			mNameIndex.erase(it);
+		}
+	}
+}
+
+void BankDB::renameAccount(int acctNum, string_view oldName, string_view newName)
+{
+	if (oldName != newName) {
+		// Index the new name first; if that throws, nothing changed.
+		indexAccount(acctNum, newName);
+		unindexAccount(acctNum, oldName);
+	}
+}
+
 bool BankDB::addAccount(const BankAccount& acct)
 {
 	// Do the actual insert, using the account number as the key
@@ -16,13 +115,28 @@ bool BankDB::addAccount(const BankAccount& acct)
 	// do the actual insert, using the account number as the key
 	//res = mAccounts.insert(make_pair(acct.getAcctNum(), acct));
 
+	if (res.second) {
+		auto& account = res.first->second;
+		try {
+			indexAccount(res.first->first, account.getClientName());
+		} catch (...) {
+			mAccounts.erase(res.first);
+			throw;
+		}
+		account.mDatabase = this;
+	}
+
 	// Return the bool field of the pair specifying success or failure
 	return res.second;
 }
 
 void BankDB::deleteAccount(int acctNum)
 {
-	mAccounts.erase(acctNum);
+	auto it = mAccounts.find(acctNum);
+	if (it != end(mAccounts)) {
+		unindexAccount(acctNum, it->second.getClientName());
+		mAccounts.erase(it);
+	}
 }
 
 BankAccount& BankDB::findAccount(int acctNum)
@@ -42,39 +156,46 @@ BankAccount& BankDB::findAccount(int acctNum)
 
 BankAccount& BankDB::findAccount(string_view name)
 {
-	// Finding an element by a non-key attribute requires a linear
-	// search through the elements. Uses C++17 structured bindings.
-	for (auto& [acctNum, account] : mAccounts) {
-		if (account.getClientName() == name) {
-			return account;  // found it!
-		}
+	// Finding an element by a non-key attribute would require a linear
+	// search through the elements. The name index avoids that.
+	auto it = mNameIndex.find(name);
+	if (it == end(mNameIndex)) {
+		throw out_of_range("No account with that name.");
 	}
+	// The index never holds empty sets; take the lowest account number.
+	return findAccount(*cbegin(it->second));
+}
 
-	// If your compiler doesn't support the above C++17 structured
-	// bindings yet, you can use the following implementation
-	//for (auto& p : mAccounts) {
-	//	if (p.second.getClientName() == name) {
-	//		return p.second;  // found it!
-	//	}
-	//}
-
-	// If your compiler doesn't support the above C++11 range based for
-	// loop, you need the following loop
-	//for (map<int, BankAccount>::iterator it = mAccounts.begin();
-	//     it != mAccounts.end(); ++it) {
-	//  if (it->second.getClientName() == name) {
-	//    return it->second;  // found it!
-	//  }
-	//}
-	throw out_of_range("No account with that name.");
+vector<int> BankDB::findAccountNumbers(string_view name) const
+{
+	auto it = mNameIndex.find(name);
+	if (it == end(mNameIndex)) {
+		return {};
+	}
+	return vector<int>(cbegin(it->second), cend(it->second));
 }
 
 void BankDB::mergeDatabase(BankDB& db)
 {
-	// Use C++17 merge().
-	mAccounts.merge(db.mAccounts);
-	// Or: mAccounts.insert(begin(db.mAccounts), end(db.mAccounts));
+	if (&db == this) {
+		return;
+	}
+
+	// Like C++17 merge(), move the nodes holding the accounts instead of
+	// copying the accounts, but index every account that is moved.
+	for (auto it = begin(db.mAccounts); it != end(db.mAccounts); ) {
+		if (mAccounts.count(it->first) != 0) {
+			// An account with that number exists already; skip it.
+			++it;
+			continue;
+		}
+		auto& account = it->second;
+		indexAccount(it->first, account.getClientName());
+		account.mDatabase = this;
+		mAccounts.insert(db.mAccounts.extract(it++));
+	}
 
 	// Now clear the source database.
 	db.mAccounts.clear();
+	db.mNameIndex.clear();
 }
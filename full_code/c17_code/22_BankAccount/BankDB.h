@@ -1,28 +1,57 @@
 #pragma once
 
 #include <map>
+#include <set>
 #include <string>
 #include <string_view>
+#include <vector>
+
+class BankDB;
 
 class BankAccount final
 {
 public:
 	BankAccount(int acctNum, std::string_view name) : mAcctNum(acctNum), mClientName(name) {}
 
-	void setAcctNum(int acctNum) { mAcctNum = acctNum; }
+	// A copy doesn't belong to a database, even if the original does.
+	BankAccount(const BankAccount& src) : mAcctNum(src.mAcctNum), mClientName(src.mClientName) {}
+	// Assigning to an account stored in a BankDB keeps it in the database
+	// under the new client name.
+	// Throws invalid_argument if rhs has a different account number.
+	BankAccount& operator=(const BankAccount& rhs);
+
+	// The number of an account stored in a BankDB can't change; it is
+	// the key of the account in the database.
+	// Throws invalid_argument if the account is stored in a BankDB.
+	void setAcctNum(int acctNum);
 	int getAcctNum() const { return mAcctNum; }
 
-	void setClientName(std::string_view name) { mClientName = name; }
+	// Renaming an account stored in a BankDB updates the name index of
+	// the database.
+	void setClientName(std::string_view name);
 	std::string_view getClientName() const { return mClientName; }
 
 private:
+	friend class BankDB;
+
 	int mAcctNum;
 	std::string mClientName;
+	// The database storing this account, or nullptr.
+	BankDB* mDatabase = nullptr;
 };
 
 class BankDB final
 {
 public:
+	BankDB() = default;
+
+	// The accounts must know which database they belong to, so copying
+	// and moving a database updates its accounts.
+	BankDB(const BankDB& src);
+	BankDB& operator=(const BankDB& rhs);
+	BankDB(BankDB&& src) noexcept;
+	BankDB& operator=(BankDB&& rhs) noexcept;
+
 	// Adds account to the bank database. If an account exists already
 	// with that number, the new account is not added. Returns true
 	// if the account is added, false if it's not.
@@ -32,16 +61,36 @@ public:
 	void deleteAccount(int acctNum);
 
 	// Returns a reference to the account represented
-	// by its number or the client name.
+	// by its number or the client name. If several accounts have
+	// that client name, returns the one with the lowest number.
 	// Throws out_of_range if the account is not found.
 	BankAccount& findAccount(int acctNum);
 	BankAccount& findAccount(std::string_view name);
 
+	// Returns the numbers of all accounts with that client name, in
+	// increasing order.
+	std::vector<int> findAccountNumbers(std::string_view name) const;
+
 	// Adds all the accounts from db to this database.
 	// Deletes all the accounts from db.
 	void mergeDatabase(BankDB& db);
 
+	friend void swap(BankDB& first, BankDB& second) noexcept;
+
 private:
+	friend class BankAccount;
+
+	// Keep the name index up to date.
+	void indexAccount(int acctNum, std::string_view name);
+	void unindexAccount(int acctNum, std::string_view name);
+	void renameAccount(int acctNum, std::string_view oldName, std::string_view newName);
+
+	// Makes all accounts refer to this database.
+	void adoptAccounts();
+
 	std::map<int, BankAccount> mAccounts;
+	// Secondary index: the account numbers for every client name, so
+	// findAccount(name) doesn't need to look at every account.
+	std::map<std::string, std::set<int>, std::less<>> mNameIndex;
 };
 
@@ -23,5 +23,42 @@ int main()
 		cout << "Unable to find account: " << caughtException.what() << endl;
 	}
 
+	// Renaming an account through the reference updates the name index.
+	cout << "Account of Nicholas A Solter: "
+		<< db.findAccount("Nicholas A Solter").getAcctNum() << endl;
+
+	// Several accounts can have the same client name.
+	BankDB other;
+	other.addAccount(BankAccount(300, "Scott Kleper"));
+	other.addAccount(BankAccount(200, "Marc Gregoire"));  // Number is taken.
+	db.mergeDatabase(other);
+	cout << "Accounts of Scott Kleper:";
+	for (int acctNum : db.findAccountNumbers("Scott Kleper")) {
+		cout << " " << acctNum;
+	}
+	cout << endl;
+
+	db.deleteAccount(200);
+	cout << "Account of Scott Kleper: "
+		<< db.findAccount("Scott Kleper").getAcctNum() << endl;
+
+	// Accounts merged into db are renamed in db's index.
+	db.findAccount(300).setClientName("Scott J Kleper");
+	cout << "Accounts of Scott Kleper: "
+		<< db.findAccountNumbers("Scott Kleper").size() << endl;
+	cout << "Account of Scott J Kleper: "
+		<< db.findAccount("Scott J Kleper").getAcctNum() << endl;
+
+	// Assigning to a stored account keeps its number, which is its key.
+	db.findAccount(100) = BankAccount(100, "Nick Solter");
+	cout << "Account of Nick Solter: "
+		<< db.findAccount("Nick Solter").getAcctNum() << endl;
+	try {
+		db.findAccount(100) = BankAccount(999, "Bob");
+	} catch (const invalid_argument& caughtException) {
+		cout << "Unable to assign: " << caughtException.what() << endl;
+	}
+	cout << "Account 100: " << db.findAccount(100).getClientName() << endl;
+
 	return 0;
 }
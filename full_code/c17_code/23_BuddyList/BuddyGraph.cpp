@@ -0,0 +1,243 @@
+#include "BuddyGraph.h"
+#include <algorithm>
+#include <future>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+
+using namespace std;
+
+BuddyGraph::UserId BuddyGraph::intern(const string& name)
+{
+	if (auto id = findId(name)) {
+		return *id;
+	}
+	if (mNames.size() == numeric_limits<UserId>::max()) {
+		throw length_error("Too many users.");
+	}
+	UserId id = static_cast<UserId>(mNames.size());
+	mIds.emplace(name, id);
+	mNames.push_back(name);
+	if (isFrozen()) {
+		// A new user has no buddies yet.
+		mOffsets.push_back(mOffsets.back());
+	} else {
+		mBuddies.emplace_back();
+	}
+	return id;
+}
+
+optional<BuddyGraph::UserId> BuddyGraph::findId(const string& name) const
+{
+	auto iter = mIds.find(name);
+	if (iter == end(mIds)) {
+		return nullopt;
+	}
+	return iter->second;
+}
+
+BuddyGraph::IdRange BuddyGraph::getBuddyIds(UserId user) const
+{
+	if (isFrozen()) {
+		const UserId* targets = mTargets.data();
+		return IdRange{ targets + mOffsets[user], targets + mOffsets[user + 1] };
+	}
+	const auto& buddies = mBuddies[user];
+	return IdRange{ buddies.data(), buddies.data() + buddies.size() };
+}
+
+vector<string> BuddyGraph::toNames(const vector<UserId>& ids) const
+{
+	vector<string> names;
+	names.reserve(ids.size());
+	for (UserId id : ids) {
+		names.push_back(mNames[id]);
+	}
+	return names;
+}
+
+void BuddyGraph::addBuddy(const string& name, const string& buddy)
+{
+	UserId user = intern(name);
+	UserId buddyId = intern(buddy);
+	thaw();
+
+	// Keep the vector sorted, and don't insert an identical copy.
+	auto& buddies = mBuddies[user];
+	auto iter = lower_bound(begin(buddies), end(buddies), buddyId);
+	if (iter == end(buddies) || *iter != buddyId) {
+		buddies.insert(iter, buddyId);
+	}
+}
+
+void BuddyGraph::removeBuddy(const string& name, const string& buddy)
+{
+	auto user = findId(name);
+	auto buddyId = findId(buddy);
+	if (!user || !buddyId) {
+		return;
+	}
+	thaw();
+
+	auto& buddies = mBuddies[*user];
+	auto iter = lower_bound(begin(buddies), end(buddies), *buddyId);
+	if (iter != end(buddies) && *iter == *buddyId) {
+		buddies.erase(iter);
+	}
+}
+
+bool BuddyGraph::isBuddy(const string& name, const string& buddy) const
+{
+	auto user = findId(name);
+	auto buddyId = findId(buddy);
+	if (!user || !buddyId) {
+		return false;
+	}
+	auto buddies = getBuddyIds(*user);
+	return binary_search(begin(buddies), end(buddies), *buddyId);
+}
+
+vector<string> BuddyGraph::getBuddies(const string& name) const
+{
+	auto user = findId(name);
+	if (!user) {
+		return {};
+	}
+	auto buddies = getBuddyIds(*user);
+	return toNames(vector<UserId>(begin(buddies), end(buddies)));
+}
+
+vector<string> BuddyGraph::mutualBuddies(const string& a, const string& b) const
+{
+	auto userA = findId(a);
+	auto userB = findId(b);
+	if (!userA || !userB) {
+		return {};
+	}
+	// Both lists are sorted, so this is a linear merge.
+	auto buddiesA = getBuddyIds(*userA);
+	auto buddiesB = getBuddyIds(*userB);
+	vector<UserId> mutual;
+	set_intersection(begin(buddiesA), end(buddiesA), begin(buddiesB), end(buddiesB),
+		back_inserter(mutual));
+	return toNames(mutual);
+}
+
+vector<string> BuddyGraph::suggestions(const string& name, size_t depth) const
+{
+	auto user = findId(name);
+	if (!user || depth < 2) {
+		return {};
+	}
+
+	// Breadth-first search. visited holds the user, the direct friends,
+	// and all users reached in earlier steps.
+	unordered_set<UserId> visited{ *user };
+	auto friends = getBuddyIds(*user);
+	visited.insert(begin(friends), end(friends));
+	vector<UserId> frontier(begin(friends), end(friends));
+
+	// Counts, for the users reached in one step, how many frontier users
+	// lead to them. Each task handles one chunk of the frontier.
+	using Counts = unordered_map<UserId, size_t>;
+	auto countStep = [this, &visited](const UserId* first, const UserId* last) {
+		Counts counts;
+		for (; first != last; ++first) {
+			for (UserId next : getBuddyIds(*first)) {
+				if (visited.count(next) == 0) {
+					++counts[next];
+				}
+			}
+		}
+		return counts;
+	};
+
+	struct Candidate
+	{
+		UserId mId;
+		size_t mStep;
+		size_t mCount;
+	};
+	vector<Candidate> candidates;
+
+	const size_t kMinChunkSize = 1024;
+	for (size_t step = 2; step <= depth && !frontier.empty(); ++step) {
+		size_t numTasks = min<size_t>(max(1u, thread::hardware_concurrency()),
+			(frontier.size() + kMinChunkSize - 1) / kMinChunkSize);
+		size_t chunkSize = (frontier.size() + numTasks - 1) / numTasks;
+
+		// The calling thread takes the first chunk itself.
+		vector<future<Counts>> futures;
+		for (size_t task = 1; task < numTasks; ++task) {
+			const UserId* first = frontier.data() + min(task * chunkSize, frontier.size());
+			const UserId* last = frontier.data() + min((task + 1) * chunkSize, frontier.size());
+			futures.push_back(async(launch::async, countStep, first, last));
+		}
+		Counts counts = countStep(frontier.data(), frontier.data() + min(chunkSize, frontier.size()));
+		for (auto& future : futures) {
+			for (const auto& [next, count] : future.get()) {
+				counts[next] += count;
+			}
+		}
+
+		frontier.clear();
+		for (const auto& [next, count] : counts) {
+			visited.insert(next);
+			frontier.push_back(next);
+			candidates.push_back(Candidate{ next, step, count });
+		}
+	}
+
+	// Nearer users first, then the most connected, then by UserId so the
+	// result doesn't depend on hash order.
+	sort(begin(candidates), end(candidates), [](const Candidate& lhs, const Candidate& rhs) {
+		if (lhs.mStep != rhs.mStep) {
+			return lhs.mStep < rhs.mStep;
+		}
+		if (lhs.mCount != rhs.mCount) {
+			return lhs.mCount > rhs.mCount;
+		}
+		return lhs.mId < rhs.mId;
+	});
+	vector<UserId> result;
+	result.reserve(candidates.size());
+	for (const auto& candidate : candidates) {
+		result.push_back(candidate.mId);
+	}
+	return toNames(result);
+}
+
+void BuddyGraph::freeze()
+{
+	if (isFrozen()) {
+		return;
+	}
+	mOffsets.reserve(mBuddies.size() + 1);
+	mOffsets.push_back(0);
+	for (const auto& buddies : mBuddies) {
+		mOffsets.push_back(mOffsets.back() + buddies.size());
+	}
+	mTargets.reserve(mOffsets.back());
+	for (const auto& buddies : mBuddies) {
+		mTargets.insert(end(mTargets), begin(buddies), end(buddies));
+	}
+	// Release the per-user vectors.
+	vector<vector<UserId>>().swap(mBuddies);
+}
+
+void BuddyGraph::thaw()
+{
+	if (!isFrozen()) {
+		return;
+	}
+	mBuddies.resize(mNames.size());
+	for (UserId user = 0; user < mNames.size(); ++user) {
+		auto buddies = getBuddyIds(user);
+		mBuddies[user].assign(begin(buddies), end(buddies));
+	}
+	vector<size_t>().swap(mOffsets);
+	vector<UserId>().swap(mTargets);
+}
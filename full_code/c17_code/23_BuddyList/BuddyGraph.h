@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// BuddyList for large social graphs. Every user name is stored once and
+// mapped to a 32-bit UserId, and the buddies of a user are a sorted
+// vector of UserIds, so an edge costs 4 bytes instead of two strings,
+// and isBuddy() is a binary search.
+//
+// For read-mostly use, freeze() packs all buddy vectors into one array
+// in compressed sparse row (CSR) form: the buddies of user u are
+// mTargets[mOffsets[u]] to mTargets[mOffsets[u + 1]]. Modifying a frozen
+// graph unpacks it again first, which takes time linear in the number of
+// edges.
+//
+// Const member functions can be called concurrently.
+class BuddyGraph final
+{
+public:
+	using UserId = uint32_t;
+
+	// Adds buddy as a friend of name.
+	void addBuddy(const std::string& name, const std::string& buddy);
+
+	// Removes buddy as a friend of name
+	void removeBuddy(const std::string& name, const std::string& buddy);
+
+	// Returns true if buddy is a friend of name, false otherwise.
+	bool isBuddy(const std::string& name, const std::string& buddy) const;
+
+	// Retrieves a list of all the friends of name, sorted by UserId.
+	std::vector<std::string> getBuddies(const std::string& name) const;
+
+	// Retrieves the users who are friends of both a and b.
+	std::vector<std::string> mutualBuddies(const std::string& a, const std::string& b) const;
+
+	// Suggests new friends for name: users reachable in 2 to depth steps
+	// who are neither name nor already friends of name. The users with
+	// the most friends in the previous step come first, so for depth 2
+	// they are ranked by the number of mutual friends with name. Large
+	// steps are processed by several threads.
+	std::vector<std::string> suggestions(const std::string& name, size_t depth = 2) const;
+
+	// Packs the graph into CSR form, or does nothing if it's already frozen.
+	void freeze();
+	bool isFrozen() const { return !mOffsets.empty(); }
+
+	size_t getNumUsers() const { return mNames.size(); }
+
+private:
+	// Pointers to the sorted buddy ids of a user.
+	struct IdRange
+	{
+		const UserId* mBegin;
+		const UserId* mEnd;
+		const UserId* begin() const { return mBegin; }
+		const UserId* end() const { return mEnd; }
+		size_t size() const { return mEnd - mBegin; }
+	};
+
+	// Returns the id of name, adding name if it's new.
+	UserId intern(const std::string& name);
+	std::optional<UserId> findId(const std::string& name) const;
+
+	IdRange getBuddyIds(UserId user) const;
+	std::vector<std::string> toNames(const std::vector<UserId>& ids) const;
+
+	// Unpacks a frozen graph into per-user vectors.
+	void thaw();
+
+	std::unordered_map<std::string, UserId> mIds;
+	std::vector<std::string> mNames;
+
+	// Buddies of every user while not frozen.
+	std::vector<std::vector<UserId>> mBuddies;
+
+	// Buddies of every user while frozen; mOffsets has one element more
+	// than there are users.
+	std::vector<size_t> mOffsets;
+	std::vector<UserId> mTargets;
+};
@@ -0,0 +1,59 @@
+#include "BuddyGraph.h"
+#include <iostream>
+#include <string>
+
+using namespace std;
+
+void printNames(const string& title, const vector<string>& names)
+{
+	cout << title << ": " << endl;
+	for (const auto& name : names) {
+		cout << "\t" << name << endl;
+	}
+}
+
+int main()
+{
+	BuddyGraph buddies;
+
+	buddies.addBuddy("Harry Potter", "Ron Weasley");
+	buddies.addBuddy("Harry Potter", "Hermione Granger");
+	buddies.addBuddy("Harry Potter", "Hagrid");
+	buddies.addBuddy("Harry Potter", "Draco Malfoy");
+	// That's not right! Remove Draco.
+	buddies.removeBuddy("Harry Potter", "Draco Malfoy");
+
+	buddies.addBuddy("Hagrid", "Harry Potter");
+	buddies.addBuddy("Hagrid", "Ron Weasley");
+	buddies.addBuddy("Hagrid", "Hermione Granger");
+	buddies.addBuddy("Hagrid", "Fang");
+
+	buddies.addBuddy("Ron Weasley", "Ginny Weasley");
+	buddies.addBuddy("Ron Weasley", "Fang");
+	buddies.addBuddy("Ginny Weasley", "Luna Lovegood");
+
+	// Pack the graph for the read-mostly phase.
+	buddies.freeze();
+
+	printNames("Harry's friends", buddies.getBuddies("Harry Potter"));
+	printNames("Friends of Harry and Hagrid", buddies.mutualBuddies("Harry Potter", "Hagrid"));
+	printNames("Suggestions for Harry", buddies.suggestions("Harry Potter"));
+	printNames("Suggestions for Harry, depth 3", buddies.suggestions("Harry Potter", 3));
+	cout << "Is Draco Harry's friend? " << boolalpha
+		<< buddies.isBuddy("Harry Potter", "Draco Malfoy") << endl;
+
+	// A large graph: every user is a friend of the next 10 users.
+	BuddyGraph large;
+	const int kNumUsers = 100'000;
+	for (int user = 0; user < kNumUsers; ++user) {
+		for (int next = 1; next <= 10; ++next) {
+			large.addBuddy(to_string(user), to_string((user + next) % kNumUsers));
+		}
+	}
+	large.freeze();
+	auto suggested = large.suggestions("0", 4);
+	cout << "Suggestions for user 0, depth 4: " << suggested.size()
+		<< ", first: " << suggested.front() << endl;
+
+	return 0;
+}
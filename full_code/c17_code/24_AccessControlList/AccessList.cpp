@@ -1,28 +1,64 @@
 #include "AccessList.h"
+#include <utility>
 
 using namespace std;
 
 AccessList::AccessList(initializer_list<string_view> initlist)
 {
-	mAllowed.insert(begin(initlist), end(initlist));
+	for (auto user : initlist) {
+		addUser(user);
+	}
 }
 
 void AccessList::addUser(string_view user)
 {
-	mAllowed.emplace(user);
+	if (mAllowed.emplace(user).second) {
+		mFilter.add(user);
+		growFilter();
+	}
 }
 
 void AccessList::removeUser(string_view user)
 {
-	mAllowed.erase(string(user));
+	auto iter = mAllowed.find(user);
+	if (iter != end(mAllowed)) {
+		mFilter.remove(user);
+		mAllowed.erase(iter);
+	}
 }
 
 bool AccessList::isAllowed(string_view user) const
 {
-	return (mAllowed.count(string(user)) != 0);
+	return mFilter.mightContain(user) && mAllowed.find(user) != end(mAllowed);
+}
+
+vector<bool> AccessList::areAllowed(const vector<string_view>& users) const
+{
+	vector<bool> result(users.size());
+	for (size_t i = 0; i < users.size(); ++i) {
+		result[i] = mFilter.mightContain(users[i]);
+	}
+	for (size_t i = 0; i < users.size(); ++i) {
+		if (result[i]) {
+			result[i] = (mAllowed.find(users[i]) != end(mAllowed));
+		}
+	}
+	return result;
 }
 
 vector<string> AccessList::getAllUsers() const
 {
 	return { begin(mAllowed), end(mAllowed) };
 }
+
+void AccessList::growFilter()
+{
+	if (mAllowed.size() * kFilterCountersPerUser <= mFilter.getNumCounters()) {
+		return;
+	}
+	CountingBloomFilter filter(2 * mFilter.getNumCounters(), mFilter.getNumHashes());
+	for (const auto& user : mAllowed) {
+		filter.add(user);
+	}
+	mFilter = move(filter);
+}
@@ -1,11 +1,16 @@
 #pragma once
 
+#include <functional>
 #include <set>
 #include <string>
 #include <string_view>
 #include <vector>
 #include <initializer_list>
+#include "BloomFilter.h"
 
+// The users are kept in a set and in a counting Bloom filter. Most users
+// who are not in the list are rejected by the filter, without searching
+// the set.
 class AccessList final
 {
 public:
@@ -24,9 +29,23 @@ public:
 	// Returns true if the user is in the permissions list.
 	bool isAllowed(std::string_view user) const;
 
+	// Returns, for every user in users, whether the user is in the
+	// permissions list. Checks the filter for all users before searching
+	// the set for the few that pass it.
+	std::vector<bool> areAllowed(const std::vector<std::string_view>& users) const;
+
 	// Returns a vector of all the users who have permissions.
 	std::vector<std::string> getAllUsers() const;
 
+	// The filter has at least this many counters per user.
+	static const size_t kFilterCountersPerUser = 16;
+
 private:
-	std::set<std::string> mAllowed;
+	// Replaces mFilter with a larger one when the list has grown, to keep
+	// the false positive rate low.
+	void growFilter();
+
+	// std::less<> allows looking up a string_view without creating a string.
+	std::set<std::string, std::less<>> mAllowed;
+	CountingBloomFilter mFilter{ 1024 };
 };
@@ -1,4 +1,5 @@
 #include "AccessList.h"
+#include "FlatAccessList.h"
 #include <iostream>
 
 using namespace std;
@@ -22,5 +23,24 @@ int main()
 	}
 	cout << endl;
 
+	// Check several users at once.
+	auto allowed = fileX.areAllowed({ "pvw", "guest", "mgregoire" });
+	cout << "pvw: " << allowed[0] << ", guest: " << allowed[1]
+		<< ", mgregoire: " << allowed[2] << endl;
+
+	// A large, read-mostly list.
+	vector<string> employees;
+	for (int i = 0; i < 100'000; ++i) {
+		employees.push_back("employee" + to_string(i));
+	}
+	FlatAccessList fileY(move(employees));
+	fileY.addUser("mgregoire");
+	int numAllowed = 0;
+	for (int i = 0; i < 200'000; ++i) {
+		numAllowed += fileY.isAllowed("employee" + to_string(i));
+	}
+	cout << "Allowed employees: " << numAllowed
+		<< ", mgregoire: " << fileY.isAllowed("mgregoire") << endl;
+
 	return 0;
 }
@@ -0,0 +1,73 @@
+#include "BloomFilter.h"
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+
+using namespace std;
+
+CountingBloomFilter::CountingBloomFilter(size_t numCounters, size_t numHashes)
+	: mNumHashes(numHashes)
+{
+	if (numCounters == 0 || numHashes == 0) {
+		throw invalid_argument("Filter needs counters and hashes.");
+	}
+	size_t size = 1;
+	while (size < numCounters) {
+		size <<= 1;
+	}
+	mCounters.resize(size);
+	mMask = size - 1;
+}
+
+CountingBloomFilter::Hashes CountingBloomFilter::getHashes(string_view key)
+{
+	// Derive all hashes from one string hash (Kirsch-Mitzenmacher): the
+	// i-th counter is hash1 + i * hash2. hash2 mixes the bits of hash1 and
+	// is odd, so the counters are distinct for a power-of-two size.
+	size_t hash1 = hash<string_view>{}(key);
+	uint64_t hash2 = hash1;
+	hash2 ^= hash2 >> 33;
+	hash2 *= 0xff51afd7ed558ccdULL;
+	hash2 ^= hash2 >> 33;
+	return Hashes{ hash1, static_cast<size_t>(hash2 | 1) };
+}
+
+void CountingBloomFilter::add(string_view key)
+{
+	Hashes hashes = getHashes(key);
+	for (size_t i = 0; i < mNumHashes; ++i) {
+		auto& counter = mCounters[getIndex(hashes, i)];
+		if (counter != numeric_limits<uint8_t>::max()) {
+			++counter;
+		}
+	}
+}
+
+void CountingBloomFilter::remove(string_view key)
+{
+	Hashes hashes = getHashes(key);
+	for (size_t i = 0; i < mNumHashes; ++i) {
+		auto& counter = mCounters[getIndex(hashes, i)];
+		// A saturated counter may count more strings than it can hold.
+		if (counter != 0 && counter != numeric_limits<uint8_t>::max()) {
+			--counter;
+		}
+	}
+}
+
+bool CountingBloomFilter::mightContain(string_view key) const
+{
+	Hashes hashes = getHashes(key);
+	for (size_t i = 0; i < mNumHashes; ++i) {
+		if (mCounters[getIndex(hashes, i)] == 0) {
+			return false;
+		}
+	}
+	return true;
+}
+
+void CountingBloomFilter::clear()
+{
+	fill(begin(mCounters), end(mCounters), 0);
+}
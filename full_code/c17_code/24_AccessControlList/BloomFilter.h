@@ -0,0 +1,50 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+// Counting Bloom filter for strings. mightContain() returns false only
+// for strings that are definitely not in the filter, and true for all
+// strings in the filter plus, rarely, some that aren't (false
+// positives). With n strings, m counters, and k hashes, the false
+// positive rate is about (1 - e^(-kn/m))^k; for m = 16n and k = 4 that's
+// under 0.3%.
+//
+// Every string increments k small counters instead of setting k bits, so
+// strings can also be removed. A counter that reaches its maximum stays
+// there, so an overflow can cause false positives but never false
+// negatives.
+class CountingBloomFilter final
+{
+public:
+	// numCounters is rounded up to a power of two.
+	// Throws invalid_argument if numCounters or numHashes is 0.
+	explicit CountingBloomFilter(size_t numCounters = 1 << 16, size_t numHashes = 4);
+
+	void add(std::string_view key);
+	// key must have been added before.
+	void remove(std::string_view key);
+	bool mightContain(std::string_view key) const;
+
+	// Removes all strings.
+	void clear();
+
+	size_t getNumCounters() const { return mCounters.size(); }
+	size_t getNumHashes() const { return mNumHashes; }
+
+private:
+	// All numHashes counters of a key are derived from two hashes.
+	struct Hashes
+	{
+		size_t mHash1;
+		size_t mHash2;
+	};
+	static Hashes getHashes(std::string_view key);
+	size_t getIndex(const Hashes& hashes, size_t i) const { return (hashes.mHash1 + i * hashes.mHash2) & mMask; }
+
+	std::vector<uint8_t> mCounters;
+	size_t mMask;
+	size_t mNumHashes;
+};
@@ -0,0 +1,78 @@
+#include "FlatAccessList.h"
+#include <algorithm>
+#include <utility>
+
+using namespace std;
+
+FlatAccessList::FlatAccessList(initializer_list<string_view> initlist)
+	: FlatAccessList(vector<string>(begin(initlist), end(initlist)))
+{
+}
+
+FlatAccessList::FlatAccessList(vector<string> users)
+	: mAllowed(move(users))
+{
+	sort(begin(mAllowed), end(mAllowed));
+	mAllowed.erase(unique(begin(mAllowed), end(mAllowed)), end(mAllowed));
+	rebuildFilter(max(mFilter.getNumCounters(), 2 * mAllowed.size() * kFilterCountersPerUser));
+}
+
+void FlatAccessList::addUser(string_view user)
+{
+	auto iter = lower_bound(begin(mAllowed), end(mAllowed), user);
+	if (iter == end(mAllowed) || *iter != user) {
+		mAllowed.emplace(iter, user);
+		mFilter.add(user);
+		growFilter();
+	}
+}
+
+void FlatAccessList::removeUser(string_view user)
+{
+	auto iter = lower_bound(begin(mAllowed), end(mAllowed), user);
+	if (iter != end(mAllowed) && *iter == user) {
+		mFilter.remove(user);
+		mAllowed.erase(iter);
+	}
+}
+
+bool FlatAccessList::contains(string_view user) const
+{
+	return binary_search(begin(mAllowed), end(mAllowed), user);
+}
+
+bool FlatAccessList::isAllowed(string_view user) const
+{
+	return mFilter.mightContain(user) && contains(user);
+}
+
+vector<bool> FlatAccessList::areAllowed(const vector<string_view>& users) const
+{
+	vector<bool> result(users.size());
+	for (size_t i = 0; i < users.size(); ++i) {
+		result[i] = mFilter.mightContain(users[i]);
+	}
+	for (size_t i = 0; i < users.size(); ++i) {
+		if (result[i]) {
+			result[i] = contains(users[i]);
+		}
+	}
+	return result;
+}
+
+void FlatAccessList::growFilter()
+{
+	if (mAllowed.size() * kFilterCountersPerUser <= mFilter.getNumCounters()) {
+		return;
+	}
+	rebuildFilter(2 * mFilter.getNumCounters());
+}
+
+void FlatAccessList::rebuildFilter(size_t numCounters)
+{
+	CountingBloomFilter filter(numCounters, mFilter.getNumHashes());
+	for (const auto& user : mAllowed) {
+		filter.add(user);
+	}
+	mFilter = move(filter);
+}
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <initializer_list>
+#include "BloomFilter.h"
+
+// AccessList for large lists that are read much more often than they
+// change. The users are stored in one sorted vector, so a lookup is a
+// binary search over contiguous memory instead of a walk through tree
+// nodes, and there is no per-node memory overhead. Adding or removing a
+// user takes linear time, so build large lists with the vector
+// constructor. Like AccessList, a counting Bloom filter rejects most
+// users who are not in the list before searching.
+class FlatAccessList final
+{
+public:
+	// Default constructor
+	FlatAccessList() = default;
+
+	// Constructor to support uniform initialization.
+	FlatAccessList(std::initializer_list<std::string_view> initlist);
+
+	// Builds the list from any number of users in O(n log n) time.
+	// Duplicates are ignored.
+	explicit FlatAccessList(std::vector<std::string> users);
+
+	// Adds the user to the permissions list.
+	void addUser(std::string_view user);
+
+	// Removes the user from the permissions list.
+	void removeUser(std::string_view user);
+
+	// Returns true if the user is in the permissions list.
+	bool isAllowed(std::string_view user) const;
+
+	// Returns, for every user in users, whether the user is in the
+	// permissions list. Checks the filter for all users before searching
+	// for the few that pass it.
+	std::vector<bool> areAllowed(const std::vector<std::string_view>& users) const;
+
+	// Returns a vector of all the users who have permissions.
+	std::vector<std::string> getAllUsers() const { return mAllowed; }
+
+	// The filter has at least this many counters per user.
+	static const size_t kFilterCountersPerUser = 16;
+
+private:
+	bool contains(std::string_view user) const;
+
+	// Replaces mFilter with a larger one when the list has grown, to keep
+	// the false positive rate low.
+	void growFilter();
+	void rebuildFilter(size_t numCounters);
+
+	// Sorted and without duplicates.
+	std::vector<std::string> mAllowed;
+	CountingBloomFilter mFilter{ 1024 };
+};
@@ -0,0 +1,130 @@
+#include "DynamicBitset.h"
+#include <bitset>
+#include <stdexcept>
+
+using namespace std;
+
+DynamicBitset::DynamicBitset(size_t size)
+	: mWords((size + kBitsPerWord - 1) / kBitsPerWord)
+	, mSize(size)
+{
+}
+
+DynamicBitset::DynamicBitset(size_t size, string_view bits)
+	: DynamicBitset(size)
+{
+	for (size_t i = 0; i < bits.size(); ++i) {
+		char c = bits[bits.size() - 1 - i];
+		if (c == '1') {
+			set(i);
+		} else if (c != '0') {
+			throw invalid_argument("Bits must be '0' or '1'");
+		}
+	}
+}
+
+void DynamicBitset::verifyPosition(size_t position) const
+{
+	if (position >= mSize) {
+		throw out_of_range("Invalid bit position");
+	}
+}
+
+void DynamicBitset::verifySameSize(const DynamicBitset& rhs) const
+{
+	if (mSize != rhs.mSize) {
+		throw invalid_argument("Bitsets have different sizes");
+	}
+}
+
+bool DynamicBitset::test(size_t position) const
+{
+	verifyPosition(position);
+	return (mWords[position / kBitsPerWord] >> (position % kBitsPerWord)) & 1;
+}
+
+DynamicBitset& DynamicBitset::set(size_t position)
+{
+	verifyPosition(position);
+	mWords[position / kBitsPerWord] |= uint64_t(1) << (position % kBitsPerWord);
+	return *this;
+}
+
+DynamicBitset& DynamicBitset::reset(size_t position)
+{
+	verifyPosition(position);
+	mWords[position / kBitsPerWord] &= ~(uint64_t(1) << (position % kBitsPerWord));
+	return *this;
+}
+
+size_t DynamicBitset::count() const
+{
+	size_t result = 0;
+	for (uint64_t word : mWords) {
+		result += bitset<kBitsPerWord>(word).count();
+	}
+	return result;
+}
+
+bool DynamicBitset::any() const
+{
+	for (uint64_t word : mWords) {
+		if (word != 0) {
+			return true;
+		}
+	}
+	return false;
+}
+
+DynamicBitset& DynamicBitset::operator&=(const DynamicBitset& rhs)
+{
+	verifySameSize(rhs);
+	for (size_t i = 0; i < mWords.size(); ++i) {
+		mWords[i] &= rhs.mWords[i];
+	}
+	return *this;
+}
+
+DynamicBitset& DynamicBitset::operator|=(const DynamicBitset& rhs)
+{
+	verifySameSize(rhs);
+	for (size_t i = 0; i < mWords.size(); ++i) {
+		mWords[i] |= rhs.mWords[i];
+	}
+	return *this;
+}
+
+DynamicBitset& DynamicBitset::operator^=(const DynamicBitset& rhs)
+{
+	verifySameSize(rhs);
+	for (size_t i = 0; i < mWords.size(); ++i) {
+		mWords[i] ^= rhs.mWords[i];
+	}
+	return *this;
+}
+
+DynamicBitset& DynamicBitset::andNot(const DynamicBitset& rhs)
+{
+	verifySameSize(rhs);
+	for (size_t i = 0; i < mWords.size(); ++i) {
+		mWords[i] &= ~rhs.mWords[i];
+	}
+	return *this;
+}
+
+bool operator==(const DynamicBitset& lhs, const DynamicBitset& rhs)
+{
+	return lhs.mSize == rhs.mSize && lhs.mWords == rhs.mWords;
+}
+
+DynamicBitset operator&(DynamicBitset lhs, const DynamicBitset& rhs) { return lhs &= rhs; }
+DynamicBitset operator|(DynamicBitset lhs, const DynamicBitset& rhs) { return lhs |= rhs; }
+DynamicBitset operator^(DynamicBitset lhs, const DynamicBitset& rhs) { return lhs ^= rhs; }
+
+ostream& operator<<(ostream& os, const DynamicBitset& bits)
+{
+	for (size_t i = bits.size(); i-- > 0;) {
+		os << (bits.test(i) ? '1' : '0');
+	}
+	return os;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string_view>
+#include <vector>
+
+// Like std::bitset, but the number of bits is chosen at run time, so a
+// CableCompany can offer any number of channels. The bits are stored in
+// a contiguous vector of 64-bit words, and the bitwise operations are
+// plain loops over those words, which compilers turn into SIMD code.
+class DynamicBitset final
+{
+public:
+	// Creates a bitset of size bits, all 0.
+	explicit DynamicBitset(size_t size = 0);
+
+	// Creates a bitset from a string of '0' and '1' characters. As with
+	// std::bitset, the last character is bit 0.
+	// Throws invalid_argument for any other character.
+	DynamicBitset(size_t size, std::string_view bits);
+
+	size_t size() const { return mSize; }
+
+	// Throw out_of_range for an invalid position.
+	bool test(size_t position) const;
+	DynamicBitset& set(size_t position);
+	DynamicBitset& reset(size_t position);
+
+	// Returns the number of bits set to 1.
+	size_t count() const;
+	bool any() const;
+	bool none() const { return !any(); }
+
+	// The binary operators throw invalid_argument if the sizes differ.
+	DynamicBitset& operator&=(const DynamicBitset& rhs);
+	DynamicBitset& operator|=(const DynamicBitset& rhs);
+	DynamicBitset& operator^=(const DynamicBitset& rhs);
+	// Clears all bits that are set in rhs (this & ~rhs).
+	DynamicBitset& andNot(const DynamicBitset& rhs);
+
+	// Calls func(position) for every bit set to 1, in increasing order.
+	template <typename Func>
+	void forEachSet(Func func) const;
+
+	friend bool operator==(const DynamicBitset& lhs, const DynamicBitset& rhs);
+	friend bool operator!=(const DynamicBitset& lhs, const DynamicBitset& rhs) { return !(lhs == rhs); }
+
+private:
+	void verifyPosition(size_t position) const;
+	void verifySameSize(const DynamicBitset& rhs) const;
+
+	static const size_t kBitsPerWord = 64;
+
+	// Bits beyond mSize in the last word are always 0.
+	std::vector<uint64_t> mWords;
+	size_t mSize;
+};
+
+DynamicBitset operator&(DynamicBitset lhs, const DynamicBitset& rhs);
+DynamicBitset operator|(DynamicBitset lhs, const DynamicBitset& rhs);
+DynamicBitset operator^(DynamicBitset lhs, const DynamicBitset& rhs);
+
+// Writes the bits like std::bitset: the highest position first.
+std::ostream& operator<<(std::ostream& os, const DynamicBitset& bits);
+
+template <typename Func>
+void DynamicBitset::forEachSet(Func func) const
+{
+	for (size_t word = 0; word < mWords.size(); ++word) {
+		// Visit the set bits by clearing the lowest one until none are left.
+		for (uint64_t bits = mWords[word]; bits != 0; bits &= bits - 1) {
+			// Count the trailing zeros: isolate the lowest set bit, and
+			// count the bits below it.
+			size_t bit = std::bitset<kBitsPerWord>((bits & (~bits + 1)) - 1).count();
+			func(word * kBitsPerWord + bit);
+		}
+	}
+}
@@ -0,0 +1,171 @@
+#include "LargeCableCompany.h"
+#include <algorithm>
+#include <stdexcept>
+
+using namespace std;
+
+LargeCableCompany::LargeCableCompany(size_t numChannels)
+	: mNumChannels(numChannels)
+	, mSubscribers(numChannels)
+{
+}
+
+void LargeCableCompany::verifyChannel(size_t channel) const
+{
+	if (channel >= mNumChannels) {
+		throw out_of_range("Invalid channel");
+	}
+}
+
+void LargeCableCompany::verifySize(const DynamicBitset& channels) const
+{
+	if (channels.size() != mNumChannels) {
+		throw invalid_argument("Wrong number of channels");
+	}
+}
+
+void LargeCableCompany::indexChannels(uint32_t id, const DynamicBitset& channels)
+{
+	channels.forEachSet([&](size_t channel) { mSubscribers[channel].add(id); });
+}
+
+void LargeCableCompany::unindexChannels(uint32_t id, const DynamicBitset& channels)
+{
+	channels.forEachSet([&](size_t channel) { mSubscribers[channel].remove(id); });
+}
+
+void LargeCableCompany::addPackage(string_view packageName, const DynamicBitset& channels)
+{
+	verifySize(channels);
+	mPackages.emplace(packageName, channels);
+}
+
+void LargeCableCompany::removePackage(string_view packageName)
+{
+	auto it = mPackages.find(packageName);
+	if (it != end(mPackages)) {
+		mPackages.erase(it);
+	}
+}
+
+const DynamicBitset& LargeCableCompany::getPackage(string_view packageName) const
+{
+	auto it = mPackages.find(packageName);
+	if (it == end(mPackages)) {
+		throw out_of_range("Invalid package");
+	}
+	return it->second;
+}
+
+void LargeCableCompany::newCustomer(string_view name, string_view package)
+{
+	newCustomer(name, getPackage(package));
+}
+
+void LargeCableCompany::newCustomer(string_view name, const DynamicBitset& channels)
+{
+	verifySize(channels);
+	if (mCustomerNames.size() > UINT32_MAX) {
+		throw length_error("Too many customers");
+	}
+	auto id = static_cast<uint32_t>(mCustomerNames.size());
+	auto result = mCustomers.emplace(name, Customer{ id, channels });
+	if (!result.second) {
+		// Customer was already in the database. Nothing changed.
+		throw invalid_argument("Duplicate customer");
+	}
+	mCustomerNames.emplace_back(name);
+	indexChannels(id, channels);
+}
+
+void LargeCableCompany::addChannel(string_view name, size_t channel)
+{
+	auto& customer = getCustomerHelper(name);
+	customer.mChannels.set(channel);
+	mSubscribers[channel].add(customer.mId);
+}
+
+void LargeCableCompany::removeChannel(string_view name, size_t channel)
+{
+	auto& customer = getCustomerHelper(name);
+	customer.mChannels.reset(channel);
+	mSubscribers[channel].remove(customer.mId);
+}
+
+void LargeCableCompany::addPackageToCustomer(string_view name, string_view package)
+{
+	auto& packageChannels = getPackage(package);
+	auto& customer = getCustomerHelper(name);
+	// Only the channels the customer doesn't have yet need indexing.
+	DynamicBitset added = packageChannels;
+	added.andNot(customer.mChannels);
+	customer.mChannels |= added;
+	indexChannels(customer.mId, added);
+}
+
+void LargeCableCompany::deleteCustomer(string_view name)
+{
+	auto it = mCustomers.find(name);
+	if (it == end(mCustomers)) {
+		return;
+	}
+	const Customer& customer = it->second;
+	unindexChannels(customer.mId, customer.mChannels);
+	mCustomerNames[customer.mId].clear();
+	mCustomers.erase(it);
+}
+
+const DynamicBitset& LargeCableCompany::getCustomerChannels(string_view name) const
+{
+	// Use const_cast() to forward to getCustomerHelper()
+	// to avoid code duplication.
+	return const_cast<LargeCableCompany*>(this)->getCustomerHelper(name).mChannels;
+}
+
+LargeCableCompany::Customer& LargeCableCompany::getCustomerHelper(string_view name)
+{
+	auto it = mCustomers.find(name);
+	if (it == end(mCustomers)) {
+		throw invalid_argument("Unknown customer");
+	}
+	return it->second;
+}
+
+size_t LargeCableCompany::getNumSubscribers(size_t channel) const
+{
+	verifyChannel(channel);
+	return mSubscribers[channel].count();
+}
+
+vector<string> LargeCableCompany::findCustomers(const vector<size_t>& withChannels,
+	const vector<size_t>& withoutChannels) const
+{
+	if (withChannels.empty()) {
+		throw invalid_argument("No channels to search for");
+	}
+	for (size_t channel : withChannels) { verifyChannel(channel); }
+	for (size_t channel : withoutChannels) { verifyChannel(channel); }
+
+	// Start from the smallest set, so every intersection is cheap.
+	auto smallest = min_element(cbegin(withChannels), cend(withChannels),
+		[this](size_t a, size_t b) { return mSubscribers[a].count() < mSubscribers[b].count(); });
+	RoaringBitmap result = mSubscribers[*smallest];
+	for (size_t channel : withChannels) {
+		if (result.empty()) {
+			break;
+		}
+		result &= mSubscribers[channel];
+	}
+	for (size_t channel : withoutChannels) {
+		if (result.empty()) {
+			break;
+		}
+		result.andNot(mSubscribers[channel]);
+	}
+
+	vector<string> names;
+	names.reserve(result.count());
+	result.forEach([&](uint32_t id) { names.push_back(mCustomerNames[id]); });
+	sort(begin(names), end(names));
+	return names;
+}
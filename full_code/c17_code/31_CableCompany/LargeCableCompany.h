@@ -0,0 +1,111 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "DynamicBitset.h"
+#include "RoaringBitmap.h"
+
+// Variant of CableCompany for thousands of channels and millions of
+// customers. The number of channels is chosen at run time, so channel
+// sets are DynamicBitsets instead of std::bitsets.
+//
+// Besides the channels of every customer, the database keeps a reverse
+// index: for every channel, the set of customers subscribing to it, as a
+// RoaringBitmap of customer IDs. Questions such as "who gets channels A
+// and B but not C?" are then answered with a few bitmap intersections and
+// differences, instead of by looking at every customer.
+class LargeCableCompany final
+{
+public:
+	explicit LargeCableCompany(size_t numChannels);
+
+	size_t getNumChannels() const { return mNumChannels; }
+
+	// Adds the package with the specified channels to the database.
+	// Throws invalid_argument if channels doesn't have getNumChannels() bits.
+	void addPackage(std::string_view packageName, const DynamicBitset& channels);
+
+	// Removes the specified package from the database.
+	void removePackage(std::string_view packageName);
+
+	// Retrieves the channels of a given package.
+	// Throws out_of_range if the package name is invalid.
+	const DynamicBitset& getPackage(std::string_view packageName) const;
+
+	// Adds customer to database with initial channels found in package.
+	// Throws out_of_range if the package name is invalid.
+	// Throws invalid_argument if the customer is already known.
+	void newCustomer(std::string_view name, std::string_view package);
+
+	// Adds customer to database with given initial channels.
+	// Throws invalid_argument if the customer is already known, or if
+	// channels doesn't have getNumChannels() bits.
+	void newCustomer(std::string_view name, const DynamicBitset& channels);
+
+	// Adds the channel to the customers profile.
+	// Throws invalid_argument if the customer is unknown.
+	// Throws out_of_range if the channel is invalid.
+	void addChannel(std::string_view name, size_t channel);
+
+	// Removes the channel from the customers profile.
+	// Throws invalid_argument if the customer is unknown.
+	// Throws out_of_range if the channel is invalid.
+	void removeChannel(std::string_view name, size_t channel);
+
+	// Adds the specified package to the customers profile.
+	// Throws out_of_range if the package name is invalid.
+	// Throws invalid_argument if the customer is unknown.
+	void addPackageToCustomer(std::string_view name, std::string_view package);
+
+	// Removes the specified customer from the database.
+	void deleteCustomer(std::string_view name);
+
+	// Retrieves the channels to which a customer subscribes.
+	// Throws invalid_argument if the customer is unknown.
+	const DynamicBitset& getCustomerChannels(std::string_view name) const;
+
+	// Returns the number of customers subscribing to the channel.
+	// Throws out_of_range if the channel is invalid.
+	size_t getNumSubscribers(size_t channel) const;
+
+	// Returns the names of all customers subscribing to every channel in
+	// withChannels and to none of the channels in withoutChannels, sorted
+	// by name. withChannels must not be empty.
+	// Throws out_of_range if a channel is invalid, and invalid_argument if
+	// withChannels is empty.
+	std::vector<std::string> findCustomers(const std::vector<size_t>& withChannels,
+		const std::vector<size_t>& withoutChannels = {}) const;
+
+private:
+	struct Customer
+	{
+		uint32_t mId;
+		DynamicBitset mChannels;
+	};
+
+	// Retrieves a customer. (non-const)
+	// Throws invalid_argument if the customer is unknown.
+	Customer& getCustomerHelper(std::string_view name);
+
+	void verifyChannel(size_t channel) const;
+	void verifySize(const DynamicBitset& channels) const;
+
+	// Adds or removes the customer in the index of every channel in channels.
+	void indexChannels(uint32_t id, const DynamicBitset& channels);
+	void unindexChannels(uint32_t id, const DynamicBitset& channels);
+
+	size_t mNumChannels;
+	std::map<std::string, DynamicBitset, std::less<>> mPackages;
+	std::map<std::string, Customer, std::less<>> mCustomers;
+
+	// Customer IDs are handed out in order and not reused; mCustomerNames
+	// maps them back to names. Names of deleted customers are left empty.
+	std::vector<std::string> mCustomerNames;
+
+	// For every channel, the IDs of the customers subscribing to it.
+	std::vector<RoaringBitmap> mSubscribers;
+};
@@ -0,0 +1,75 @@
+#include "LargeCableCompany.h"
+#include <iostream>
+#include <random>
+#include <string>
+using namespace std;
+
+int main()
+{
+	LargeCableCompany myCC(10);
+	myCC.addPackage("basic", DynamicBitset(10, "1111000000"));
+	myCC.addPackage("premium", DynamicBitset(10, "1111111111"));
+	myCC.addPackage("sports", DynamicBitset(10, "0000100111"));
+
+	myCC.newCustomer("Marc G.", "basic");
+	myCC.addPackageToCustomer("Marc G.", "sports");
+	cout << myCC.getCustomerChannels("Marc G.") << endl;
+
+	myCC.newCustomer("Scott K.", "premium");
+	myCC.newCustomer("Peter V.", "sports");
+	myCC.removeChannel("Scott K.", 1);
+
+	// Who gets channels 0 and 2, but not channel 1?
+	for (const auto& name : myCC.findCustomers({ 0, 2 }, { 1 })) {
+		cout << name << endl;
+	}
+
+	// Many channels and customers: every customer gets a random selection
+	// of channels, and a few premium customers get all of them.
+	const size_t numChannels = 5000;
+	const size_t numCustomers = 100000;
+	LargeCableCompany bigCC(numChannels);
+	DynamicBitset all(numChannels);
+	for (size_t channel = 0; channel < numChannels; ++channel) {
+		all.set(channel);
+	}
+	bigCC.addPackage("all", all);
+
+	mt19937 engine(42);
+	uniform_int_distribution<size_t> channelDist(0, numChannels - 1);
+	for (size_t i = 0; i < numCustomers; ++i) {
+		string name = "customer" + to_string(i);
+		if (i % 1000 == 0) {
+			bigCC.newCustomer(name, "all");
+			continue;
+		}
+		DynamicBitset channels(numChannels);
+		for (int j = 0; j < 50; ++j) {
+			channels.set(channelDist(engine));
+		}
+		// Channel 0 is popular.
+		if (i % 2 == 0) {
+			channels.set(0);
+		}
+		bigCC.newCustomer(name, channels);
+	}
+	bigCC.deleteCustomer("customer0");
+
+	cout << "Subscribers of channel 0: " << bigCC.getNumSubscribers(0) << endl;
+	cout << "Subscribers of channel 1: " << bigCC.getNumSubscribers(1) << endl;
+
+	// Compare the index with checking every customer.
+	vector<size_t> with{ 0, 1 }, without{ 2 };
+	auto found = bigCC.findCustomers(with, without);
+	size_t expected = 0;
+	for (size_t i = 1; i < numCustomers; ++i) {
+		auto& channels = bigCC.getCustomerChannels("customer" + to_string(i));
+		if (channels.test(0) && channels.test(1) && !channels.test(2)) {
+			++expected;
+		}
+	}
+	cout << "Channels 0 and 1 but not 2: " << found.size()
+		<< " customers (expected " << expected << ")" << endl;
+
+	return 0;
+}
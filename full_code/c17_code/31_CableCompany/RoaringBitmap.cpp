@@ -0,0 +1,260 @@
+#include "RoaringBitmap.h"
+#include <algorithm>
+#include <iterator>
+#include <utility>
+
+using namespace std;
+
+bool RoaringBitmap::Chunk::contains(uint16_t low) const
+{
+	if (isBitmap()) {
+		return (mBitmap[low / 64] >> (low % 64)) & 1;
+	}
+	return binary_search(begin(mArray), end(mArray), low);
+}
+
+void RoaringBitmap::Chunk::add(uint16_t low)
+{
+	if (contains(low)) {
+		return;
+	}
+	if (isBitmap()) {
+		mBitmap[low / 64] |= uint64_t(1) << (low % 64);
+	} else {
+		mArray.insert(lower_bound(begin(mArray), end(mArray), low), low);
+	}
+	++mCount;
+	normalize();
+}
+
+void RoaringBitmap::Chunk::remove(uint16_t low)
+{
+	if (!contains(low)) {
+		return;
+	}
+	if (isBitmap()) {
+		mBitmap[low / 64] &= ~(uint64_t(1) << (low % 64));
+	} else {
+		mArray.erase(lower_bound(begin(mArray), end(mArray), low));
+	}
+	--mCount;
+	normalize();
+}
+
+void RoaringBitmap::Chunk::recount()
+{
+	if (!isBitmap()) {
+		mCount = mArray.size();
+		return;
+	}
+	mCount = 0;
+	for (uint64_t word : mBitmap) {
+		mCount += bitset<64>(word).count();
+	}
+}
+
+void RoaringBitmap::Chunk::normalize()
+{
+	if (!isBitmap() && mCount > kMaxArraySize) {
+		mBitmap.assign(kNumWords, 0);
+		for (uint16_t low : mArray) {
+			mBitmap[low / 64] |= uint64_t(1) << (low % 64);
+		}
+		vector<uint16_t>().swap(mArray);
+	} else if (isBitmap() && mCount <= kMaxArraySize) {
+		vector<uint16_t> values;
+		values.reserve(mCount);
+		forEach([&](uint16_t low) { values.push_back(low); });
+		mArray = move(values);
+		vector<uint64_t>().swap(mBitmap);
+	}
+}
+
+void RoaringBitmap::Chunk::intersect(const Chunk& rhs)
+{
+	if (isBitmap() && rhs.isBitmap()) {
+		for (size_t i = 0; i < kNumWords; ++i) {
+			mBitmap[i] &= rhs.mBitmap[i];
+		}
+	} else {
+		// At least one side is an array, so the result is at most as
+		// large as that array. Filter it through the other side.
+		const Chunk& small = isBitmap() ? rhs : *this;
+		const Chunk& other = isBitmap() ? *this : rhs;
+		vector<uint16_t> result;
+		copy_if(begin(small.mArray), end(small.mArray), back_inserter(result),
+			[&](uint16_t low) { return other.contains(low); });
+		mArray = move(result);
+		vector<uint64_t>().swap(mBitmap);
+	}
+	recount();
+	normalize();
+}
+
+void RoaringBitmap::Chunk::unite(const Chunk& rhs)
+{
+	if (!isBitmap() && !rhs.isBitmap()) {
+		vector<uint16_t> result;
+		set_union(begin(mArray), end(mArray), begin(rhs.mArray), end(rhs.mArray),
+			back_inserter(result));
+		mArray = move(result);
+	} else {
+		if (!isBitmap()) {
+			// Continue with a copy of the bitmap, and add the array values.
+			vector<uint16_t> values = move(mArray);
+			mArray.clear();
+			mBitmap = rhs.mBitmap;
+			for (uint16_t low : values) {
+				mBitmap[low / 64] |= uint64_t(1) << (low % 64);
+			}
+		} else if (!rhs.isBitmap()) {
+			for (uint16_t low : rhs.mArray) {
+				mBitmap[low / 64] |= uint64_t(1) << (low % 64);
+			}
+		} else {
+			for (size_t i = 0; i < kNumWords; ++i) {
+				mBitmap[i] |= rhs.mBitmap[i];
+			}
+		}
+	}
+	recount();
+	normalize();
+}
+
+void RoaringBitmap::Chunk::subtract(const Chunk& rhs)
+{
+	if (!isBitmap()) {
+		mArray.erase(remove_if(begin(mArray), end(mArray),
+			[&](uint16_t low) { return rhs.contains(low); }), end(mArray));
+	} else if (!rhs.isBitmap()) {
+		for (uint16_t low : rhs.mArray) {
+			mBitmap[low / 64] &= ~(uint64_t(1) << (low % 64));
+		}
+	} else {
+		for (size_t i = 0; i < kNumWords; ++i) {
+			mBitmap[i] &= ~rhs.mBitmap[i];
+		}
+	}
+	recount();
+	normalize();
+}
+
+vector<RoaringBitmap::Chunk>::iterator RoaringBitmap::findChunk(uint16_t key)
+{
+	auto iter = lower_bound(begin(mChunks), end(mChunks), key,
+		[](const Chunk& chunk, uint16_t key) { return chunk.getKey() < key; });
+	return (iter != end(mChunks) && iter->getKey() == key) ? iter : end(mChunks);
+}
+
+vector<RoaringBitmap::Chunk>::const_iterator RoaringBitmap::findChunk(uint16_t key) const
+{
+	return const_cast<RoaringBitmap*>(this)->findChunk(key);
+}
+
+void RoaringBitmap::add(uint32_t id)
+{
+	uint16_t key = static_cast<uint16_t>(id >> 16);
+	auto iter = lower_bound(begin(mChunks), end(mChunks), key,
+		[](const Chunk& chunk, uint16_t key) { return chunk.getKey() < key; });
+	if (iter == end(mChunks) || iter->getKey() != key) {
+		iter = mChunks.insert(iter, Chunk(key));
+	}
+	iter->add(static_cast<uint16_t>(id));
+}
+
+void RoaringBitmap::remove(uint32_t id)
+{
+	auto iter = findChunk(static_cast<uint16_t>(id >> 16));
+	if (iter != end(mChunks)) {
+		iter->remove(static_cast<uint16_t>(id));
+		if (iter->count() == 0) {
+			mChunks.erase(iter);
+		}
+	}
+}
+
+bool RoaringBitmap::contains(uint32_t id) const
+{
+	auto iter = findChunk(static_cast<uint16_t>(id >> 16));
+	return iter != end(mChunks) && iter->contains(static_cast<uint16_t>(id));
+}
+
+size_t RoaringBitmap::count() const
+{
+	size_t result = 0;
+	for (const auto& chunk : mChunks) {
+		result += chunk.count();
+	}
+	return result;
+}
+
+vector<uint32_t> RoaringBitmap::toVector() const
+{
+	vector<uint32_t> result;
+	result.reserve(count());
+	forEach([&](uint32_t id) { result.push_back(id); });
+	return result;
+}
+
+RoaringBitmap& RoaringBitmap::operator&=(const RoaringBitmap& rhs)
+{
+	vector<Chunk> result;
+	auto other = begin(rhs.mChunks);
+	for (auto& chunk : mChunks) {
+		// Both chunk vectors are sorted by key; skip to the matching key.
+		while (other != end(rhs.mChunks) && other->getKey() < chunk.getKey()) {
+			++other;
+		}
+		if (other != end(rhs.mChunks) && other->getKey() == chunk.getKey()) {
+			chunk.intersect(*other);
+			if (chunk.count() > 0) {
+				result.push_back(move(chunk));
+			}
+		}
+	}
+	mChunks = move(result);
+	return *this;
+}
+
+RoaringBitmap& RoaringBitmap::operator|=(const RoaringBitmap& rhs)
+{
+	vector<Chunk> result;
+	auto mine = begin(mChunks);
+	auto other = begin(rhs.mChunks);
+	while (mine != end(mChunks) || other != end(rhs.mChunks)) {
+		if (other == end(rhs.mChunks) || (mine != end(mChunks) && mine->getKey() < other->getKey())) {
+			result.push_back(move(*mine++));
+		} else if (mine == end(mChunks) || other->getKey() < mine->getKey()) {
+			result.push_back(*other++);
+		} else {
+			mine->unite(*other++);
+			result.push_back(move(*mine++));
+		}
+	}
+	mChunks = move(result);
+	return *this;
+}
+
+RoaringBitmap& RoaringBitmap::andNot(const RoaringBitmap& rhs)
+{
+	vector<Chunk> result;
+	for (auto& chunk : mChunks) {
+		auto other = rhs.findChunk(chunk.getKey());
+		if (other != end(rhs.mChunks)) {
+			chunk.subtract(*other);
+		}
+		if (chunk.count() > 0) {
+			result.push_back(move(chunk));
+		}
+	}
+	mChunks = move(result);
+	return *this;
+}
+
+bool operator==(const RoaringBitmap& lhs, const RoaringBitmap& rhs)
+{
+	return lhs.mChunks == rhs.mChunks;
+}
+
+RoaringBitmap operator&(RoaringBitmap lhs, const RoaringBitmap& rhs) { return lhs &= rhs; }
+RoaringBitmap operator|(RoaringBitmap lhs, const RoaringBitmap& rhs) { return lhs |= rhs; }
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Compressed set of 32-bit IDs, organized like a Roaring bitmap. IDs are
+// grouped into chunks by their high 16 bits. A chunk with few IDs stores
+// their low 16 bits in a sorted array. A chunk with more than 4096 IDs
+// stores a bitmap of 65536 bits (8 KB), which is then the smaller
+// representation. Sparse and dense sets are both compact, and
+// intersections, unions, and differences work chunk by chunk, with word
+// operations for bitmap chunks.
+class RoaringBitmap final
+{
+public:
+	void add(uint32_t id);
+	void remove(uint32_t id);
+	bool contains(uint32_t id) const;
+
+	// Returns the number of IDs in the set.
+	size_t count() const;
+	bool empty() const { return mChunks.empty(); }
+
+	// Calls func(id) for every ID, in increasing order.
+	template <typename Func>
+	void forEach(Func func) const;
+
+	std::vector<uint32_t> toVector() const;
+
+	RoaringBitmap& operator&=(const RoaringBitmap& rhs);
+	RoaringBitmap& operator|=(const RoaringBitmap& rhs);
+	// Removes all IDs that are in rhs.
+	RoaringBitmap& andNot(const RoaringBitmap& rhs);
+
+	friend bool operator==(const RoaringBitmap& lhs, const RoaringBitmap& rhs);
+
+private:
+	class Chunk
+	{
+	public:
+		explicit Chunk(uint16_t key) : mKey(key) {}
+
+		uint16_t getKey() const { return mKey; }
+		size_t count() const { return mCount; }
+		bool isBitmap() const { return !mBitmap.empty(); }
+
+		void add(uint16_t low);
+		void remove(uint16_t low);
+		bool contains(uint16_t low) const;
+
+		// Calls func(low) for every value, in increasing order.
+		template <typename Func>
+		void forEach(Func func) const;
+
+		// Replace this chunk with the intersection, union, or difference
+		// with rhs, which must have the same key.
+		void intersect(const Chunk& rhs);
+		void unite(const Chunk& rhs);
+		void subtract(const Chunk& rhs);
+
+		// Chunks with the same values have the same representation.
+		friend bool operator==(const Chunk& lhs, const Chunk& rhs)
+		{
+			return lhs.mKey == rhs.mKey && lhs.mCount == rhs.mCount &&
+				lhs.mArray == rhs.mArray && lhs.mBitmap == rhs.mBitmap;
+		}
+
+	private:
+		// Makes the chunk a bitmap if it has more than kMaxArraySize values,
+		// and an array otherwise.
+		void normalize();
+		void recount();
+
+		static const size_t kMaxArraySize = 4096;
+		static const size_t kNumWords = 65536 / 64;
+
+		uint16_t mKey;
+		size_t mCount = 0;
+		// Exactly one of these is used: mArray is sorted, mBitmap has
+		// kNumWords words. After every operation, the chunk is a bitmap
+		// exactly if mCount > kMaxArraySize.
+		std::vector<uint16_t> mArray;
+		std::vector<uint64_t> mBitmap;
+	};
+
+	// Returns the chunk for key, or end(mChunks) if there is none.
+	std::vector<Chunk>::iterator findChunk(uint16_t key);
+	std::vector<Chunk>::const_iterator findChunk(uint16_t key) const;
+
+	// Sorted by key; empty chunks are removed.
+	std::vector<Chunk> mChunks;
+};
+
+RoaringBitmap operator&(RoaringBitmap lhs, const RoaringBitmap& rhs);
+RoaringBitmap operator|(RoaringBitmap lhs, const RoaringBitmap& rhs);
+
+template <typename Func>
+void RoaringBitmap::Chunk::forEach(Func func) const
+{
+	if (!isBitmap()) {
+		for (uint16_t low : mArray) {
+			func(low);
+		}
+		return;
+	}
+	for (size_t word = 0; word < kNumWords; ++word) {
+		for (uint64_t bits = mBitmap[word]; bits != 0; bits &= bits - 1) {
+			// The number of trailing zeros is the position of the lowest set bit.
+			size_t bit = std::bitset<64>((bits & (~bits + 1)) - 1).count();
+			func(static_cast<uint16_t>(word * 64 + bit));
+		}
+	}
+}
+
+template <typename Func>
+void RoaringBitmap::forEach(Func func) const
+{
+	for (const auto& chunk : mChunks) {
+		uint32_t high = uint32_t(chunk.getKey()) << 16;
+		chunk.forEach([&](uint16_t low) { func(high | low); });
+	}
+}
@@ -0,0 +1,124 @@
+#include "PolicyBenchmark.h"
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace std;
+
+void printUsage()
+{
+	cerr << "Usage: ParallelBenchmark [option...]" << endl
+		<< "  --sizes=1e3,1e6        numbers of elements (default 1e3,1e4,1e5,1e6)" << endl
+		<< "  --types=int,string     int, double, string (default all)" << endl
+		<< "  --distributions=random sorted, reversed, random, duplicates (default all)" << endl
+		<< "  --algorithms=sort,...  default all of:";
+	for (const auto& name : getAlgorithmNames()) {
+		cerr << " " << name;
+	}
+	cerr << endl
+		<< "  --policies=seq,par     seq, par, par_unseq (default all)" << endl
+		<< "  --warmups=N            unmeasured runs per benchmark (default 1)" << endl
+		<< "  --repetitions=N        measured runs per benchmark (default 5)" << endl
+		<< "  --format=csv|json      output format (default csv)" << endl
+		<< "  --output=FILE          write the results to FILE instead of stdout" << endl;
+}
+
+// Splits a comma-separated list.
+vector<string> splitList(string_view list)
+{
+	vector<string> result;
+	istringstream istr{ string(list) };
+	string item;
+	while (getline(istr, item, ',')) {
+		if (!item.empty()) {
+			result.push_back(item);
+		}
+	}
+	return result;
+}
+
+// Parses a non-negative number, also in scientific notation such as 1e9.
+size_t parseCount(const string& text)
+{
+	size_t end = 0;
+	double value = stod(text, &end);
+	if (end != text.size() || value < 0) {
+		throw invalid_argument("Invalid number: " + text);
+	}
+	return static_cast<size_t>(value);
+}
+
+int main(int argc, char* argv[])
+{
+	BenchmarkOptions options;
+	string format = "csv";
+	string outputFile;
+
+	try {
+		for (int i = 1; i < argc; ++i) {
+			string_view arg = argv[i];
+			if (arg == "--help") {
+				printUsage();
+				return 0;
+			}
+			auto equals = arg.find('=');
+			if (arg.substr(0, 2) != "--" || equals == string_view::npos) {
+				throw invalid_argument("Invalid argument: " + string(arg));
+			}
+			string_view name = arg.substr(2, equals - 2);
+			string value{ arg.substr(equals + 1) };
+			if (name == "sizes") {
+				options.mSizes.clear();
+				for (const auto& size : splitList(value)) {
+					options.mSizes.push_back(parseCount(size));
+				}
+			} else if (name == "types") {
+				options.mTypes = splitList(value);
+			} else if (name == "distributions") {
+				options.mDistributions = splitList(value);
+			} else if (name == "algorithms") {
+				options.mAlgorithms = splitList(value);
+			} else if (name == "policies") {
+				options.mPolicies = splitList(value);
+			} else if (name == "warmups") {
+				options.mWarmUps = parseCount(value);
+			} else if (name == "repetitions") {
+				options.mRepetitions = parseCount(value);
+			} else if (name == "format" && (value == "csv" || value == "json")) {
+				format = value;
+			} else if (name == "output") {
+				outputFile = value;
+			} else {
+				throw invalid_argument("Invalid argument: " + string(arg));
+			}
+		}
+
+		// Open the output before running, so a bad path fails right away,
+		// and write every result as soon as it is measured, so the results
+		// so far are kept if a later benchmark fails.
+		ofstream file;
+		if (!outputFile.empty()) {
+			file.open(outputFile);
+			if (!file) {
+				throw runtime_error("Failed to create " + outputFile);
+			}
+		}
+		ostream& os = outputFile.empty() ? cout : file;
+		ResultWriter writer(os, format == "json" ? ResultWriter::Format::Json : ResultWriter::Format::Csv);
+		runBenchmarks(options, cerr, [&](const BenchmarkResult& result) { writer.write(result); });
+		writer.finish();
+	} catch (const invalid_argument& caughtException) {
+		cerr << caughtException.what() << endl;
+		printUsage();
+		return 1;
+	} catch (const exception& caughtException) {
+		cerr << caughtException.what() << endl;
+		return 1;
+	}
+
+	return 0;
+}
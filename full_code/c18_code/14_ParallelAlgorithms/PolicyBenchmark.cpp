@@ -0,0 +1,480 @@
+#include "PolicyBenchmark.h"
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <execution>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <iterator>
+#include <new>
+#include <numeric>
+#include <random>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+using namespace std;
+
+// The results of the algorithms are added to this variable, so the
+// compiler can't leave out the calls.
+static volatile size_t gSink = 0;
+
+enum class Algorithm
+{
+	Sort, StableSort, NthElement, Reduce, TransformReduce, InclusiveScan,
+	ExclusiveScan, AdjacentDifference, Transform, ForEach, CountIf, Find,
+	MinMaxElement, IsSorted, CopyIf, UniqueCopy
+};
+
+struct AlgorithmInfo
+{
+	string_view mName;
+	Algorithm mAlgorithm;
+	// Only for numbers, because there is no meaningful + for strings.
+	bool mNumericOnly;
+	// Changes the data, so every run needs a fresh copy. The others run
+	// on the generated data directly.
+	bool mModifiesData;
+	// Writes its result to another range of the same size as the data.
+	bool mWritesOutput;
+};
+
+static const AlgorithmInfo kAlgorithms[] = {
+	{ "sort", Algorithm::Sort, false, true, false },
+	{ "stable_sort", Algorithm::StableSort, false, true, false },
+	{ "nth_element", Algorithm::NthElement, false, true, false },
+	{ "reduce", Algorithm::Reduce, true, false, false },
+	{ "transform_reduce", Algorithm::TransformReduce, false, false, false },
+	{ "inclusive_scan", Algorithm::InclusiveScan, true, false, false },
+	{ "exclusive_scan", Algorithm::ExclusiveScan, true, false, false },
+	{ "adjacent_difference", Algorithm::AdjacentDifference, true, false, true },
+	{ "transform", Algorithm::Transform, true, false, true },
+	{ "for_each", Algorithm::ForEach, true, true, false },
+	{ "count_if", Algorithm::CountIf, false, false, false },
+	{ "find", Algorithm::Find, false, false, false },
+	{ "minmax_element", Algorithm::MinMaxElement, false, false, false },
+	{ "is_sorted", Algorithm::IsSorted, false, false, false },
+	{ "copy_if", Algorithm::CopyIf, false, false, true },
+	{ "unique_copy", Algorithm::UniqueCopy, false, false, true },
+};
+
+const vector<string>& getAlgorithmNames()
+{
+	static const vector<string> names = [] {
+		vector<string> result;
+		for (const auto& info : kAlgorithms) {
+			result.emplace_back(info.mName);
+		}
+		return result;
+	}();
+	return names;
+}
+
+Statistics summarize(vector<double> times)
+{
+	if (times.empty()) {
+		throw invalid_argument("No times to summarize");
+	}
+	sort(begin(times), end(times));
+	Statistics result;
+	size_t n = times.size();
+	result.mMin = times.front();
+	result.mMax = times.back();
+	result.mMedian = (n % 2 == 1) ? times[n / 2] : (times[n / 2 - 1] + times[n / 2]) / 2;
+	result.mMean = accumulate(cbegin(times), cend(times), 0.0) / n;
+	if (n > 1) {
+		double sumOfSquares = 0;
+		for (double time : times) {
+			sumOfSquares += (time - result.mMean) * (time - result.mMean);
+		}
+		// Sample standard deviation.
+		result.mStandardDeviation = sqrt(sumOfSquares / (n - 1));
+	}
+	return result;
+}
+
+// Creates an element from 64 random bits. Values are never equal to
+// getMissingValue<T>(), which find() searches for.
+template <typename T>
+T makeValue(uint64_t bits)
+{
+	if constexpr (is_same_v<T, int>) {
+		return static_cast<int>(bits % INT_MAX);
+	} else if constexpr (is_same_v<T, double>) {
+		// Uniform in [0, 1).
+		return (bits >> 11) * 0x1.0p-53;
+	} else {
+		static const char kDigits[] = "0123456789abcdef";
+		string result(16, '0');
+		for (auto& c : result) {
+			c = kDigits[bits & 15];
+			bits >>= 4;
+		}
+		return result;
+	}
+}
+
+template <typename T>
+T getMissingValue()
+{
+	if constexpr (is_same_v<T, string>) {
+		return "not a hex number";
+	} else {
+		return T(-1);
+	}
+}
+
+// Type of the sums computed by reduce() and the scans. Random ints are up
+// to INT_MAX, so their sums are computed as long long, which holds the
+// sum of up to 2^32 of them.
+template <typename T>
+using SumType = conditional_t<is_integral_v<T>, long long, T>;
+
+// Converts an element to a number, for transform_reduce().
+template <typename T>
+double toNumber(const T& value)
+{
+	if constexpr (is_same_v<T, string>) {
+		return static_cast<double>(value.size());
+	} else {
+		return static_cast<double>(value);
+	}
+}
+
+template <typename T>
+vector<T> generateData(const string& distribution, size_t size)
+{
+	// The same seed for every run, so runs can be compared.
+	mt19937_64 engine(size);
+	vector<T> data;
+	data.reserve(size);
+	if (distribution == "duplicates") {
+		vector<T> pool;
+		for (int i = 0; i < 100; ++i) {
+			pool.push_back(makeValue<T>(engine()));
+		}
+		for (size_t i = 0; i < size; ++i) {
+			data.push_back(pool[engine() % pool.size()]);
+		}
+		return data;
+	}
+	for (size_t i = 0; i < size; ++i) {
+		data.push_back(makeValue<T>(engine()));
+	}
+	if (distribution == "sorted") {
+		sort(begin(data), end(data));
+	} else if (distribution == "reversed") {
+		sort(begin(data), end(data), greater<>());
+	}
+	return data;
+}
+
+// Runs the algorithm once on data, using output for algorithms that
+// write their result to another range, and sums for the scans.
+template <typename T, typename Policy>
+void runAlgorithm(Algorithm algorithm, Policy&& policy, vector<T>& data, vector<T>& output,
+	vector<SumType<T>>& sums)
+{
+	auto first = begin(data);
+	auto last = end(data);
+	const T pivot = data[data.size() / 2];
+
+	if constexpr (is_arithmetic_v<T>) {
+		switch (algorithm) {
+		case Algorithm::Reduce:
+			gSink = gSink + static_cast<size_t>(reduce(policy, first, last, SumType<T>()));
+			return;
+		case Algorithm::InclusiveScan:
+			// Without an initial value, the sums would have type T.
+			inclusive_scan(policy, first, last, begin(sums), plus<>(), SumType<T>());
+			return;
+		case Algorithm::ExclusiveScan:
+			exclusive_scan(policy, first, last, begin(sums), SumType<T>());
+			return;
+		case Algorithm::AdjacentDifference:
+			adjacent_difference(policy, first, last, begin(output));
+			return;
+		case Algorithm::Transform:
+			transform(policy, first, last, begin(output), [](T value) { return value / 2; });
+			return;
+		case Algorithm::ForEach:
+			for_each(policy, first, last, [](T& value) { value /= 2; });
+			return;
+		default:
+			break;
+		}
+	}
+
+	switch (algorithm) {
+	case Algorithm::Sort:
+		sort(policy, first, last);
+		break;
+	case Algorithm::StableSort:
+		stable_sort(policy, first, last);
+		break;
+	case Algorithm::NthElement:
+		nth_element(policy, first, first + data.size() / 2, last);
+		break;
+	case Algorithm::TransformReduce:
+		gSink = gSink + static_cast<size_t>(transform_reduce(policy, first, last, 0.0,
+			plus<>(), [](const T& value) { return toNumber(value); }));
+		break;
+	case Algorithm::CountIf:
+		gSink = gSink + count_if(policy, first, last, [&](const T& value) { return value < pivot; });
+		break;
+	case Algorithm::Find:
+		gSink = gSink + (find(policy, first, last, getMissingValue<T>()) - first);
+		break;
+	case Algorithm::MinMaxElement:
+		gSink = gSink + (minmax_element(policy, first, last).second - first);
+		break;
+	case Algorithm::IsSorted:
+		gSink = gSink + is_sorted(policy, first, last);
+		break;
+	case Algorithm::CopyIf:
+		gSink = gSink + (copy_if(policy, first, last, begin(output),
+			[&](const T& value) { return value < pivot; }) - begin(output));
+		break;
+	case Algorithm::UniqueCopy:
+		gSink = gSink + (unique_copy(policy, first, last, begin(output)) - begin(output));
+		break;
+	default:
+		// Numeric algorithm on strings; skipped by the caller.
+		break;
+	}
+}
+
+template <typename Func>
+void withPolicy(const string& policy, Func func)
+{
+	if (policy == "seq") {
+		func(execution::seq);
+	} else if (policy == "par") {
+		func(execution::par);
+	} else {
+		func(execution::par_unseq);
+	}
+}
+
+template <typename T>
+void benchmarkType(const BenchmarkOptions& options, const vector<const AlgorithmInfo*>& allAlgorithms,
+	const string& type, vector<BenchmarkResult>& results, ostream& log,
+	const function<void(const BenchmarkResult&)>& onResult)
+{
+	using Clock = chrono::steady_clock;
+
+	// Numeric algorithms don't apply to strings.
+	vector<const AlgorithmInfo*> algorithms;
+	copy_if(cbegin(allAlgorithms), cend(allAlgorithms), back_inserter(algorithms), [](const auto* info) {
+		return is_arithmetic_v<T> || !info->mNumericOnly;
+	});
+	auto anySelected = [&](auto predicate) { return any_of(cbegin(algorithms), cend(algorithms), predicate); };
+	// Only allocate the buffers that one of the algorithms uses.
+	bool needsWork = anySelected([](const auto* info) { return info->mModifiesData; });
+	bool needsOutput = anySelected([](const auto* info) { return info->mWritesOutput; });
+	bool needsSums = anySelected([](const auto* info) {
+		return info->mAlgorithm == Algorithm::InclusiveScan || info->mAlgorithm == Algorithm::ExclusiveScan;
+	});
+
+	// seq first, so the speed-up of the other policies is known as soon
+	// as they have been measured.
+	vector<string> policies = options.mPolicies;
+	stable_partition(begin(policies), end(policies), [](const string& policy) { return policy == "seq"; });
+
+	for (const auto& distribution : options.mDistributions) {
+		for (size_t size : options.mSizes) {
+			if (size == 0) {
+				continue;
+			}
+			log << type << ", " << distribution << ", " << size << " elements" << endl;
+			vector<T> data, work, output;
+			vector<SumType<T>> sums;
+			try {
+				data = generateData<T>(distribution, size);
+				if (needsWork) {
+					work.resize(size);
+				}
+				if (needsOutput) {
+					output.resize(size);
+				}
+				if (needsSums) {
+					sums.resize(size);
+				}
+			} catch (const bad_alloc&) {
+				log << "  Skipped: not enough memory" << endl;
+				continue;
+			}
+
+			for (const auto* info : algorithms) {
+				double sequentialMedian = 0;
+				for (const auto& policy : policies) {
+					vector<double> times;
+					for (size_t run = 0; run < options.mWarmUps + options.mRepetitions; ++run) {
+						if (info->mModifiesData) {
+							// Copying isn't part of the measured time.
+							copy(cbegin(data), cend(data), begin(work));
+						}
+						auto& input = info->mModifiesData ? work : data;
+						auto start = Clock::now();
+						withPolicy(policy, [&](auto&& executionPolicy) {
+							runAlgorithm(info->mAlgorithm, executionPolicy, input, output, sums);
+						});
+						chrono::duration<double, milli> elapsed = Clock::now() - start;
+						if (run >= options.mWarmUps) {
+							times.push_back(elapsed.count());
+						}
+					}
+
+					BenchmarkResult result;
+					result.mType = type;
+					result.mDistribution = distribution;
+					result.mSize = size;
+					result.mAlgorithm = string(info->mName);
+					result.mPolicy = policy;
+					result.mRepetitions = times.size();
+					result.mStatistics = summarize(move(times));
+					// Compare with seq on the same benchmark.
+					if (policy == "seq") {
+						sequentialMedian = result.mStatistics.mMedian;
+					}
+					if (sequentialMedian > 0 && result.mStatistics.mMedian > 0) {
+						result.mSpeedUp = sequentialMedian / result.mStatistics.mMedian;
+					}
+					if (onResult) {
+						onResult(result);
+					}
+					results.push_back(move(result));
+				}
+			}
+		}
+	}
+}
+
+template <size_t N>
+void verifyNames(const vector<string>& names, const char* const (&valid)[N], const char* what)
+{
+	for (const auto& name : names) {
+		if (find(begin(valid), end(valid), name) == end(valid)) {
+			throw invalid_argument("Unknown " + string(what) + ": " + name);
+		}
+	}
+}
+
+vector<BenchmarkResult> runBenchmarks(const BenchmarkOptions& options, ostream& log,
+	const function<void(const BenchmarkResult&)>& onResult)
+{
+	static const char* const kTypes[] = { "int", "double", "string" };
+	static const char* const kDistributions[] = { "sorted", "reversed", "random", "duplicates" };
+	static const char* const kPolicies[] = { "seq", "par", "par_unseq" };
+	verifyNames(options.mTypes, kTypes, "type");
+	verifyNames(options.mDistributions, kDistributions, "distribution");
+	verifyNames(options.mPolicies, kPolicies, "policy");
+	if (options.mRepetitions == 0) {
+		throw invalid_argument("At least one repetition is needed");
+	}
+
+	vector<const AlgorithmInfo*> algorithms;
+	for (const auto& info : kAlgorithms) {
+		if (options.mAlgorithms.empty() ||
+			find(cbegin(options.mAlgorithms), cend(options.mAlgorithms), info.mName) != cend(options.mAlgorithms)) {
+			algorithms.push_back(&info);
+		}
+	}
+	for (const auto& name : options.mAlgorithms) {
+		const auto& names = getAlgorithmNames();
+		if (find(cbegin(names), cend(names), name) == cend(names)) {
+			throw invalid_argument("Unknown algorithm: " + name);
+		}
+	}
+
+	vector<BenchmarkResult> results;
+	for (const auto& type : options.mTypes) {
+		if (type == "int") {
+			benchmarkType<int>(options, algorithms, type, results, log, onResult);
+		} else if (type == "double") {
+			benchmarkType<double>(options, algorithms, type, results, log, onResult);
+		} else {
+			benchmarkType<string>(options, algorithms, type, results, log, onResult);
+		}
+	}
+	return results;
+}
+
+ResultWriter::ResultWriter(ostream& os, Format format)
+	: mOutput(os), mFormat(format)
+{
+	if (mFormat == Format::Csv) {
+		mOutput << "type,distribution,size,algorithm,policy,repetitions,"
+			<< "min_ms,median_ms,mean_ms,stddev_ms,max_ms,speedup" << endl;
+	} else {
+		mOutput << "[" << flush;
+	}
+}
+
+ResultWriter::~ResultWriter()
+{
+	try {
+		finish();
+	} catch (...) {
+		// Destructors must not throw.
+	}
+}
+
+void ResultWriter::write(const BenchmarkResult& result)
+{
+	const auto& stats = result.mStatistics;
+	if (mFormat == Format::Csv) {
+		mOutput << result.mType << ',' << result.mDistribution << ',' << result.mSize << ','
+			<< result.mAlgorithm << ',' << result.mPolicy << ',' << result.mRepetitions << ','
+			<< stats.mMin << ',' << stats.mMedian << ',' << stats.mMean << ','
+			<< stats.mStandardDeviation << ',' << stats.mMax << ',' << result.mSpeedUp << endl;
+	} else {
+		// All strings are names from this file, which need no escaping.
+		mOutput << (mNumWritten == 0 ? "\n" : ",\n")
+			<< "  { \"type\": \"" << result.mType << "\""
+			<< ", \"distribution\": \"" << result.mDistribution << "\""
+			<< ", \"size\": " << result.mSize
+			<< ", \"algorithm\": \"" << result.mAlgorithm << "\""
+			<< ", \"policy\": \"" << result.mPolicy << "\""
+			<< ", \"repetitions\": " << result.mRepetitions
+			<< ", \"min_ms\": " << stats.mMin
+			<< ", \"median_ms\": " << stats.mMedian
+			<< ", \"mean_ms\": " << stats.mMean
+			<< ", \"stddev_ms\": " << stats.mStandardDeviation
+			<< ", \"max_ms\": " << stats.mMax
+			<< ", \"speedup\": " << result.mSpeedUp << " }" << flush;
+	}
+	++mNumWritten;
+}
+
+void ResultWriter::finish()
+{
+	if (mFinished) {
+		return;
+	}
+	mFinished = true;
+	if (mFormat == Format::Json) {
+		mOutput << "\n]" << endl;
+	}
+}
+
+static void writeAll(ostream& os, const vector<BenchmarkResult>& results, ResultWriter::Format format)
+{
+	ResultWriter writer(os, format);
+	for (const auto& result : results) {
+		writer.write(result);
+	}
+	writer.finish();
+}
+
+void writeCsv(ostream& os, const vector<BenchmarkResult>& results)
+{
+	writeAll(os, results, ResultWriter::Format::Csv);
+}
+
+void writeJson(ostream& os, const vector<BenchmarkResult>& results)
+{
+	writeAll(os, results, ResultWriter::Format::Json);
+}
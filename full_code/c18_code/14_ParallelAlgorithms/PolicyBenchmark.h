@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// Measures how long the standard algorithms take with the execution
+// policies seq, par, and par_unseq, to find out from which input sizes
+// the parallel policies pay off on a given machine.
+//
+// Every combination of element type, distribution, and size gets its own
+// generated data set. Algorithms that change the data get a fresh copy
+// of it before every run; the others read it directly. Buffers for the
+// copy and for output ranges are only allocated if a selected algorithm
+// needs them. Every algorithm runs a few times without measuring
+// (warm-up), then a number of measured repetitions, which are summarized
+// with statistics.
+
+struct BenchmarkOptions
+{
+	// Number of elements; 1e9 elements need several GB of memory.
+	std::vector<size_t> mSizes{ 1'000, 10'000, 100'000, 1'000'000 };
+	// "int", "double", "string".
+	std::vector<std::string> mTypes{ "int", "double", "string" };
+	// "sorted", "reversed", "random", "duplicates" (100 distinct values).
+	std::vector<std::string> mDistributions{ "sorted", "reversed", "random", "duplicates" };
+	// Any of getAlgorithmNames().
+	std::vector<std::string> mAlgorithms;
+	// "seq", "par", "par_unseq".
+	std::vector<std::string> mPolicies{ "seq", "par", "par_unseq" };
+	size_t mWarmUps = 1;
+	size_t mRepetitions = 5;
+};
+
+// Summary of the measured times of one benchmark, in milliseconds.
+struct Statistics
+{
+	double mMin = 0;
+	double mMax = 0;
+	double mMean = 0;
+	double mMedian = 0;
+	double mStandardDeviation = 0;
+};
+
+// Throws invalid_argument if times is empty.
+Statistics summarize(std::vector<double> times);
+
+struct BenchmarkResult
+{
+	std::string mType;
+	std::string mDistribution;
+	size_t mSize = 0;
+	std::string mAlgorithm;
+	std::string mPolicy;
+	size_t mRepetitions = 0;
+	Statistics mStatistics;
+	// Median time with seq divided by the median time with this policy;
+	// 0 if seq wasn't measured.
+	double mSpeedUp = 0;
+};
+
+// Returns the names of all algorithms that can be benchmarked.
+const std::vector<std::string>& getAlgorithmNames();
+
+// Runs all benchmarks selected in options; an empty list of algorithms
+// selects all of them. Algorithms that don't apply to an element type,
+// such as inclusive_scan for strings, are skipped. Progress is reported
+// on log, and onResult is called with every result as soon as it has
+// been measured, so results survive a later failure. seq is measured
+// first, so the speed-up is known by then.
+// Throws invalid_argument for an unknown type, distribution, algorithm,
+// or policy, or if the number of repetitions is 0.
+std::vector<BenchmarkResult> runBenchmarks(const BenchmarkOptions& options, std::ostream& log,
+	const std::function<void(const BenchmarkResult&)>& onResult = {});
+
+// Writes results one at a time as CSV with a header line, or as a JSON
+// array, flushing after every result. The JSON array is closed by
+// finish() or by the destructor.
+class ResultWriter
+{
+public:
+	enum class Format { Csv, Json };
+
+	ResultWriter(std::ostream& os, Format format);
+	~ResultWriter();
+	ResultWriter(const ResultWriter&) = delete;
+	ResultWriter& operator=(const ResultWriter&) = delete;
+
+	void write(const BenchmarkResult& result);
+	void finish();
+
+private:
+	std::ostream& mOutput;
+	Format mFormat;
+	size_t mNumWritten = 0;
+	bool mFinished = false;
+};
+
+// Write all results at once.
+void writeCsv(std::ostream& os, const std::vector<BenchmarkResult>& results);
+void writeJson(std::ostream& os, const std::vector<BenchmarkResult>& results);
@@ -0,0 +1,113 @@
+#include "ParallelVoterAudit.h"
+#include <algorithm>
+#include <execution>
+#include <functional>
+#include <numeric>
+#include <string_view>
+#include <thread>
+
+using namespace std;
+
+ParallelVoterAudit::ParallelVoterAudit(size_t numPartitions)
+	: mNumPartitions(numPartitions != 0 ? numPartitions : 4 * max(1u, thread::hardware_concurrency()))
+{
+}
+
+size_t ParallelVoterAudit::getPartition(const string& name) const
+{
+	// The hash set of a partition picks buckets with the low bits of the
+	// same hash. If those bits also chose the partition, each set would
+	// only fill a fraction of its buckets.
+	return (hash<string>{}(name) >> 20) % mNumPartitions;
+}
+
+ParallelVoterAudit::NameSets ParallelVoterAudit::findDuplicates(const VotersMap& votersByDistrict) const
+{
+	// Split the districts into slices. Every slice sorts pointers to its
+	// names into partitions; the names themselves are not copied.
+	struct Slice
+	{
+		const string* mFirst;
+		const string* mLast;
+		vector<vector<const string*>> mPartitions;
+	};
+	vector<Slice> slices;
+	for (const auto& [district, voters] : votersByDistrict) {
+		for (size_t first = 0; first < voters.size(); first += kSliceSize) {
+			size_t last = min(first + kSliceSize, voters.size());
+			slices.push_back({ voters.data() + first, voters.data() + last, {} });
+		}
+	}
+
+	// Scatter the slices in parallel.
+	for_each(execution::par, begin(slices), end(slices), [this](Slice& slice) {
+		slice.mPartitions.resize(mNumPartitions);
+		for (auto name = slice.mFirst; name != slice.mLast; ++name) {
+			slice.mPartitions[getPartition(*name)].push_back(name);
+		}
+	});
+
+	// Then find the duplicates of the partitions in parallel, with one
+	// hash set per partition.
+	vector<size_t> partitions(mNumPartitions);
+	iota(begin(partitions), end(partitions), 0);
+	NameSets duplicates(mNumPartitions);
+	for_each(execution::par, begin(partitions), end(partitions), [&](size_t partition) {
+		size_t numNames = 0;
+		for (const auto& slice : slices) {
+			numNames += slice.mPartitions[partition].size();
+		}
+		unordered_set<string_view> seen;
+		seen.reserve(numNames);
+		for (auto& slice : slices) {
+			for (const string* name : slice.mPartitions[partition]) {
+				if (!seen.insert(*name).second) {
+					duplicates[partition].insert(*name);
+				}
+			}
+			// Release the memory as early as possible.
+			vector<const string*>().swap(slice.mPartitions[partition]);
+		}
+	});
+	return duplicates;
+}
+
+unordered_set<string> ParallelVoterAudit::getDuplicates(const VotersMap& votersByDistrict) const
+{
+	NameSets partitions = findDuplicates(votersByDistrict);
+	unordered_set<string> duplicates;
+	for (auto& partition : partitions) {
+		while (!partition.empty()) {
+			duplicates.insert(move(partition.extract(cbegin(partition)).value()));
+		}
+	}
+	return duplicates;
+}
+
+void ParallelVoterAudit::auditVoterRolls(VotersMap& votersByDistrict,
+	const vector<string>& convictedFelons) const
+{
+	// Get all the duplicate names, and add the convicted felons to the
+	// partition they belong to.
+	NameSets toRemove = findDuplicates(votersByDistrict);
+	for (const auto& felon : convictedFelons) {
+		toRemove[getPartition(felon)].insert(felon);
+	}
+
+	// Filter the districts in place with the remove-erase-idiom, largest
+	// districts first, so a large one isn't left for the end.
+	vector<vector<string>*> districts;
+	for (auto& [district, voters] : votersByDistrict) {
+		districts.push_back(&voters);
+	}
+	sort(begin(districts), end(districts),
+		[](const auto* a, const auto* b) { return a->size() > b->size(); });
+
+	for_each(execution::par, begin(districts), end(districts), [&](vector<string>* district) {
+		auto& voters = *district;
+		auto it = remove_if(begin(voters), end(voters), [&](const string& name) {
+			return toRemove[getPartition(name)].count(name) > 0;
+		});
+		voters.erase(it, end(voters));
+	});
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <map>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using VotersMap = std::map<std::string, std::vector<std::string>>;
+
+// Audits voter rolls like auditVoterRolls() in AuditVoterRolls.cpp, but
+// with the parallel algorithms (std::execution::par) and without sorting
+// all names, for national rolls with hundreds of millions of voters.
+//
+// Names are hash-partitioned: a name always goes to the same partition,
+// so all copies of a name end up together, and the duplicates of each
+// partition can be found with a hash set, independently of the other
+// partitions. The names to remove are kept in per-partition hash sets
+// too, and the districts are filtered in place, several at a time.
+//
+// As with all parallel algorithms, std::terminate() is called if an
+// exception, such as bad_alloc, escapes from the work on one partition.
+class ParallelVoterAudit final
+{
+public:
+	// numPartitions = 0 uses four partitions per processor core, so the
+	// work is spread evenly even if some partitions are larger.
+	explicit ParallelVoterAudit(size_t numPartitions = 0);
+
+	// Returns all names that appear more than once in the map, in the
+	// same district or in different ones.
+	std::unordered_set<std::string> getDuplicates(const VotersMap& votersByDistrict) const;
+
+	// Removes from each vector any name on the convictedFelons vector and
+	// any name that appears more than once in the map. The remaining
+	// names keep their order.
+	void auditVoterRolls(VotersMap& votersByDistrict,
+		const std::vector<std::string>& convictedFelons) const;
+
+private:
+	using NameSets = std::vector<std::unordered_set<std::string>>;
+
+	// Returns the duplicates, as one set per partition.
+	NameSets findDuplicates(const VotersMap& votersByDistrict) const;
+
+	size_t getPartition(const std::string& name) const;
+
+	// Districts are split into slices of at most this many names, so
+	// large districts are spread over several threads.
+	static const size_t kSliceSize = 1 << 16;
+
+	size_t mNumPartitions;
+};
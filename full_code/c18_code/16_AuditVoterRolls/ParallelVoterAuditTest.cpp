@@ -0,0 +1,73 @@
+#include "ParallelVoterAudit.h"
+#include <chrono>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+int main()
+{
+	VotersMap voters = {
+		{ "Orange", { "Amy Aardvark", "Bob Buffalo", "Charles Cat", "Dwayne Dog" } },
+		{ "Los Angeles", { "Elizabeth Elephant", "Fred Flamingo", "Amy Aardvark" } },
+		{ "San Diego", { "George Goose", "Heidi Hen", "Fred Flamingo" } }
+	};
+
+	vector<string> felons = { "Bob Buffalo", "Charles Cat" };
+
+	auto printDistricts = [](const VotersMap& votersByDistrict) {
+		for (const auto& [district, names] : votersByDistrict) {
+			cout << district << ":";
+			for (auto& str : names) {
+				cout << " {" << str << "}";
+			}
+			cout << endl;
+		}
+		cout << endl;
+	};
+
+	ParallelVoterAudit audit;
+
+	cout << "Before Audit:" << endl;
+	printDistricts(voters);
+
+	audit.auditVoterRolls(voters, felons);
+
+	cout << "After Audit:" << endl;
+	printDistricts(voters);
+
+	// A larger roll: 1000 districts with 2 million voters in total. Voter
+	// numbers are drawn from a range of 10 million, so some voters are
+	// registered twice.
+	VotersMap country;
+	mt19937 engine(42);
+	uniform_int_distribution<int> voterDist(0, 9'999'999);
+	for (int district = 0; district < 1000; ++district) {
+		auto& names = country["District " + to_string(district)];
+		names.reserve(2000);
+		for (int i = 0; i < 2000; ++i) {
+			names.push_back("Voter " + to_string(voterDist(engine)));
+		}
+	}
+	vector<string> countryFelons;
+	for (int i = 0; i < 10000; ++i) {
+		countryFelons.push_back("Voter " + to_string(voterDist(engine)));
+	}
+
+	auto start = chrono::steady_clock::now();
+	size_t numDuplicates = audit.getDuplicates(country).size();
+	audit.auditVoterRolls(country, countryFelons);
+	auto elapsed = chrono::duration_cast<chrono::milliseconds>(chrono::steady_clock::now() - start);
+
+	size_t numRemaining = 0;
+	for (const auto& [district, names] : country) {
+		numRemaining += names.size();
+	}
+	cout << "Duplicates: " << numDuplicates << endl;
+	cout << "Remaining voters: " << numRemaining << endl;
+	cout << "Audit took " << elapsed.count() << " ms" << endl;
+
+	return 0;
+}
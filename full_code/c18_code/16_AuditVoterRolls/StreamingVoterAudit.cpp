@@ -0,0 +1,419 @@
+#include "StreamingVoterAudit.h"
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <queue>
+#include <random>
+#include <set>
+#include <stdexcept>
+#include <system_error>
+#include <unordered_set>
+#include <utility>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static ofstream openForWriting(const fs::path& file, ios_base::openmode mode = ios_base::out)
+{
+	ofstream ostr(file, mode);
+	if (!ostr) {
+		throw runtime_error("Failed to create " + file.string());
+	}
+	return ostr;
+}
+
+static ifstream openForReading(const fs::path& file, ios_base::openmode mode = ios_base::in)
+{
+	ifstream istr(file, mode);
+	if (!istr) {
+		throw runtime_error("Failed to open " + file.string());
+	}
+	return istr;
+}
+
+static void closeAfterWriting(ofstream& ostr, const fs::path& file)
+{
+	ostr.close();
+	if (!ostr) {
+		throw runtime_error("Failed to write " + file.string());
+	}
+}
+
+// Reads the next non-empty line, without a '\r' at the end.
+static bool readLine(istream& istr, string& line)
+{
+	while (getline(istr, line)) {
+		if (!line.empty() && line.back() == '\r') {
+			line.pop_back();
+		}
+		if (!line.empty()) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// The temporary files are binary: numbers are stored as they are in
+// memory, and names as their length followed by their characters.
+static void writeNumber(ostream& ostr, uint64_t value)
+{
+	ostr.write(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+static bool readNumber(istream& istr, uint64_t& value)
+{
+	return bool(istr.read(reinterpret_cast<char*>(&value), sizeof(value)));
+}
+
+static void writeName(ostream& ostr, string_view name)
+{
+	writeNumber(ostr, name.size());
+	ostr.write(name.data(), name.size());
+}
+
+static bool readName(istream& istr, string& name)
+{
+	uint64_t size;
+	if (!readNumber(istr, size)) {
+		return false;
+	}
+	name.resize(size);
+	return bool(istr.read(name.data(), size));
+}
+
+// Removes the temporary directory with all files in it.
+class WorkDirectory final
+{
+public:
+	explicit WorkDirectory(const fs::path& parent)
+	{
+		random_device seeder;
+		do {
+			mPath = parent / ("voter-audit-" + to_string(seeder()));
+		} while (!fs::create_directories(mPath));
+	}
+	~WorkDirectory()
+	{
+		error_code error;
+		fs::remove_all(mPath, error);
+	}
+
+	WorkDirectory(const WorkDirectory& src) = delete;
+	WorkDirectory& operator=(const WorkDirectory& rhs) = delete;
+
+	const fs::path& getPath() const { return mPath; }
+
+private:
+	fs::path mPath;
+};
+
+// Writes names to the files of a set of partitions. The felons are
+// written first, then the names with their positions, so only one file
+// per partition is open at a time.
+class StreamingVoterAudit::Spiller final
+{
+public:
+	Spiller(const fs::path& directory, const string& prefix, size_t fanOut, int level)
+		: mLevel(level)
+	{
+		for (size_t i = 0; i < fanOut; ++i) {
+			auto name = prefix + "-" + to_string(i);
+			mPartitions.push_back({ directory / (name + ".records"), directory / (name + ".felons") });
+		}
+	}
+
+	// feed(spill) must call spill(name) for every felon.
+	template <typename Feed>
+	void spillFelons(Feed feed)
+	{
+		auto files = openAll(&Partition::mFelons);
+		feed([&](string_view name) {
+			writeName(files[getIndex(name)], name);
+		});
+		closeAll(files, &Partition::mFelons);
+	}
+
+	// feed(spill) must call spill(position, name) for every name, in the
+	// order of the positions.
+	template <typename Feed>
+	void spillRecords(Feed feed)
+	{
+		auto files = openAll(&Partition::mRecords);
+		feed([&](const Position& position, string_view name) {
+			auto& file = files[getIndex(name)];
+			writeNumber(file, position.mDistrict);
+			writeNumber(file, position.mLine);
+			writeName(file, name);
+		});
+		closeAll(files, &Partition::mRecords);
+	}
+
+	const vector<Partition>& getPartitions() const { return mPartitions; }
+
+private:
+	size_t getIndex(string_view name) const
+	{
+		return getPartitionHash(name, mLevel) % mPartitions.size();
+	}
+
+	vector<ofstream> openAll(fs::path Partition::* file) const
+	{
+		vector<ofstream> files;
+		for (const auto& partition : mPartitions) {
+			files.push_back(openForWriting(partition.*file, ios_base::binary));
+		}
+		return files;
+	}
+
+	void closeAll(vector<ofstream>& files, fs::path Partition::* file) const
+	{
+		for (size_t i = 0; i < files.size(); ++i) {
+			closeAfterWriting(files[i], mPartitions[i].*file);
+		}
+	}
+
+	int mLevel;
+	vector<Partition> mPartitions;
+};
+
+StreamingVoterAudit::StreamingVoterAudit(size_t memoryBudget, fs::path tempDirectory)
+	: mMemoryBudget(memoryBudget)
+	, mTempDirectory(move(tempDirectory))
+{
+	if (memoryBudget < kMinMemoryBudget) {
+		throw invalid_argument("Memory budget too small");
+	}
+}
+
+size_t StreamingVoterAudit::getPartitionHash(string_view name, int level)
+{
+	// Mix the level into the hash with the finalizer of splitmix64.
+	uint64_t hash = std::hash<string_view>{}(name) + uint64_t(level) * 0x9e3779b97f4a7c15;
+	hash = (hash ^ (hash >> 30)) * 0xbf58476d1ce4e5b9;
+	hash = (hash ^ (hash >> 27)) * 0x94d049bb133111eb;
+	return static_cast<size_t>(hash ^ (hash >> 31));
+}
+
+size_t StreamingVoterAudit::getFanOut(uintmax_t spillBytes) const
+{
+	uintmax_t memory = spillBytes * kMemoryPerSpillByte;
+	uintmax_t fanOut = (memory + mMemoryBudget - 1) / mMemoryBudget;
+	if (fanOut > kMaxFanOut) {
+		return kMaxFanOut;
+	}
+	return fanOut > 0 ? static_cast<size_t>(fanOut) : 1;
+}
+
+void StreamingVoterAudit::auditPartition(const Partition& partition, int level,
+	const fs::path& workDirectory, vector<fs::path>& runs, Result& result) const
+{
+	uintmax_t spillBytes = fs::file_size(partition.mRecords) + fs::file_size(partition.mFelons);
+	if (spillBytes * kMemoryPerSpillByte > mMemoryBudget && level < kMaxLevel) {
+		// Too large for the budget: split it with the hash of the next level.
+		Spiller spiller(workDirectory, partition.mRecords.stem().string(),
+			max<size_t>(2, getFanOut(spillBytes)), level + 1);
+		spiller.spillFelons([&](auto spill) {
+			auto felons = openForReading(partition.mFelons, ios_base::binary);
+			string name;
+			while (readName(felons, name)) {
+				spill(name);
+			}
+		});
+		spiller.spillRecords([&](auto spill) {
+			auto records = openForReading(partition.mRecords, ios_base::binary);
+			Position position;
+			string name;
+			while (readNumber(records, position.mDistrict) &&
+				readNumber(records, position.mLine) && readName(records, name)) {
+				spill(position, name);
+			}
+		});
+		fs::remove(partition.mRecords);
+		fs::remove(partition.mFelons);
+		for (const auto& part : spiller.getPartitions()) {
+			auditPartition(part, level + 1, workDirectory, runs, result);
+		}
+		return;
+	}
+
+	++result.mNumPartitions;
+	unordered_set<string> toRemove;
+	{
+		auto felons = openForReading(partition.mFelons, ios_base::binary);
+		string name;
+		while (readName(felons, name)) {
+			toRemove.insert(name);
+		}
+	}
+	{
+		// All copies of a name are in this partition, so the duplicates
+		// found here are all duplicates of these names.
+		auto records = openForReading(partition.mRecords, ios_base::binary);
+		unordered_set<string> seen;
+		Position position;
+		string name;
+		while (readNumber(records, position.mDistrict) &&
+			readNumber(records, position.mLine) && readName(records, name)) {
+			if (!seen.insert(name).second) {
+				toRemove.insert(name);
+			}
+		}
+	}
+
+	// The records are in the order of their positions, so the run is too.
+	auto runFile = fs::path(partition.mRecords).replace_extension(".run");
+	{
+		auto records = openForReading(partition.mRecords, ios_base::binary);
+		auto run = openForWriting(runFile, ios_base::binary);
+		Position position;
+		string name;
+		while (readNumber(records, position.mDistrict) &&
+			readNumber(records, position.mLine) && readName(records, name)) {
+			if (toRemove.count(name) > 0) {
+				writeNumber(run, position.mDistrict);
+				writeNumber(run, position.mLine);
+			}
+		}
+		closeAfterWriting(run, runFile);
+	}
+	fs::remove(partition.mRecords);
+	fs::remove(partition.mFelons);
+	runs.push_back(runFile);
+}
+
+fs::path StreamingVoterAudit::mergeRuns(vector<fs::path> runs, const fs::path& workDirectory) const
+{
+	size_t numMerged = 0;
+	if (runs.empty()) {
+		auto empty = workDirectory / "empty.run";
+		auto run = openForWriting(empty, ios_base::binary);
+		closeAfterWriting(run, empty);
+		return empty;
+	}
+
+	// Merge at most kMaxFanOut runs at a time, until one run is left.
+	while (runs.size() > 1) {
+		vector<fs::path> merged;
+		for (size_t first = 0; first < runs.size(); first += kMaxFanOut) {
+			size_t last = min(first + kMaxFanOut, runs.size());
+			if (last - first == 1) {
+				merged.push_back(runs[first]);
+				continue;
+			}
+
+			vector<ifstream> inputs;
+			for (size_t i = first; i < last; ++i) {
+				inputs.push_back(openForReading(runs[i], ios_base::binary));
+			}
+			auto outputFile = workDirectory / ("merged-" + to_string(numMerged++) + ".run");
+			auto output = openForWriting(outputFile, ios_base::binary);
+
+			// Min-heap of the next position of every input.
+			using Entry = pair<Position, size_t>;
+			auto greater = [](const Entry& lhs, const Entry& rhs) { return rhs.first < lhs.first; };
+			priority_queue<Entry, vector<Entry>, decltype(greater)> heap(greater);
+			auto readNext = [&](size_t input) {
+				Position position;
+				if (readNumber(inputs[input], position.mDistrict) &&
+					readNumber(inputs[input], position.mLine)) {
+					heap.push({ position, input });
+				}
+			};
+			for (size_t input = 0; input < inputs.size(); ++input) {
+				readNext(input);
+			}
+			while (!heap.empty()) {
+				auto [position, input] = heap.top();
+				heap.pop();
+				writeNumber(output, position.mDistrict);
+				writeNumber(output, position.mLine);
+				readNext(input);
+			}
+			closeAfterWriting(output, outputFile);
+			inputs.clear();
+			for (size_t i = first; i < last; ++i) {
+				fs::remove(runs[i]);
+			}
+			merged.push_back(outputFile);
+		}
+		runs = move(merged);
+	}
+	return runs[0];
+}
+
+StreamingVoterAudit::Result StreamingVoterAudit::audit(const vector<fs::path>& districtFiles,
+	const fs::path& felonsFile, const fs::path& outputDirectory) const
+{
+	// Every district needs its own output file, and no output file may
+	// replace one of the inputs before it has been read again.
+	set<fs::path> inputs = { fs::weakly_canonical(felonsFile) };
+	for (const auto& file : districtFiles) {
+		inputs.insert(fs::weakly_canonical(file));
+	}
+	set<fs::path> outputNames;
+	for (const auto& file : districtFiles) {
+		if (!outputNames.insert(file.filename()).second) {
+			throw invalid_argument("Several districts have the file name " + file.filename().string());
+		}
+		if (inputs.count(fs::weakly_canonical(outputDirectory / file.filename())) != 0) {
+			throw invalid_argument("Output would overwrite " + (outputDirectory / file.filename()).string());
+		}
+	}
+
+	Result result;
+	WorkDirectory workDirectory(mTempDirectory);
+	const auto& work = workDirectory.getPath();
+
+	// 1. Partition the felons and the names. Spill files are about as
+	// large as the input, plus the positions.
+	uintmax_t inputBytes = fs::file_size(felonsFile);
+	for (const auto& file : districtFiles) {
+		inputBytes += fs::file_size(file);
+	}
+	Spiller spiller(work, "p", getFanOut(inputBytes * 2), 0);
+	spiller.spillFelons([&](auto spill) {
+		auto felons = openForReading(felonsFile);
+		string name;
+		while (readLine(felons, name)) {
+			spill(name);
+		}
+	});
+	spiller.spillRecords([&](auto spill) {
+		for (size_t district = 0; district < districtFiles.size(); ++district) {
+			auto voters = openForReading(districtFiles[district]);
+			string name;
+			for (uint64_t line = 0; readLine(voters, name); ++line) {
+				spill(Position{ district, line }, name);
+				++result.mNumVoters;
+			}
+		}
+	});
+
+	// 2. Audit the partitions one by one.
+	vector<fs::path> runs;
+	for (const auto& partition : spiller.getPartitions()) {
+		auditPartition(partition, 0, work, runs, result);
+	}
+
+	// 3. Copy the districts, skipping the positions in the merged run.
+	auto removals = openForReading(mergeRuns(move(runs), work), ios_base::binary);
+	Position next;
+	bool hasNext = readNumber(removals, next.mDistrict) && readNumber(removals, next.mLine);
+	fs::create_directories(outputDirectory);
+	for (size_t district = 0; district < districtFiles.size(); ++district) {
+		auto voters = openForReading(districtFiles[district]);
+		auto outputFile = outputDirectory / districtFiles[district].filename();
+		auto output = openForWriting(outputFile);
+		string name;
+		for (uint64_t line = 0; readLine(voters, name); ++line) {
+			if (hasNext && next == Position{ district, line }) {
+				++result.mNumRemoved;
+				hasNext = readNumber(removals, next.mDistrict) && readNumber(removals, next.mLine);
+			} else {
+				output << name << '\n';
+			}
+		}
+		closeAfterWriting(output, outputFile);
+	}
+	return result;
+}
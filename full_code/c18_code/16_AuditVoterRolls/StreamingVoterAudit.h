@@ -0,0 +1,113 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Audits voter rolls that don't fit in memory. Every district is a file
+// with one voter name per line, and the audited rolls are written to new
+// files. As in auditVoterRolls(), names of convicted felons and names
+// that appear more than once, in one district or in several, are
+// removed; the remaining names keep their order.
+//
+// The files are streamed, and memory use stays within a budget:
+// 1. The names are read once and written to temporary files, one per
+//    hash partition, together with their position (district and line).
+//    The felons are partitioned the same way.
+// 2. Each partition is audited on its own: a hash set finds its
+//    duplicates, and the positions of the names to remove are written to
+//    a run file, in order. A partition too large for the budget is split
+//    again, with a different hash, first.
+// 3. The runs are merged into one ordered stream of positions, and the
+//    districts are read again and written out without the lines at those
+//    positions.
+class StreamingVoterAudit final
+{
+public:
+	struct Result
+	{
+		size_t mNumVoters = 0;
+		size_t mNumRemoved = 0;
+		// Number of partitions audited, including the ones split off.
+		size_t mNumPartitions = 0;
+	};
+
+	// memoryBudget is the approximate number of bytes the hash sets of
+	// one partition may use. Temporary files go to a new directory in
+	// tempDirectory, which is removed afterwards.
+	// Throws invalid_argument if memoryBudget is below kMinMemoryBudget.
+	explicit StreamingVoterAudit(size_t memoryBudget,
+		std::filesystem::path tempDirectory = std::filesystem::temp_directory_path());
+
+	// Reads the district files and the felons file, which have one name
+	// per line, and writes the audited districts to outputDirectory, with
+	// the same file names. Empty lines and a '\r' at the end of a line are
+	// ignored.
+	// Throws runtime_error if a file can't be read or written, and
+	// invalid_argument if two district files have the same file name, or
+	// if an output file would overwrite one of the input files.
+	Result audit(const std::vector<std::filesystem::path>& districtFiles,
+		const std::filesystem::path& felonsFile,
+		const std::filesystem::path& outputDirectory) const;
+
+	static const size_t kMinMemoryBudget = 1 << 20;
+
+private:
+	// Position of a name: the index of its district, and the number of
+	// the name within the district.
+	struct Position
+	{
+		uint64_t mDistrict;
+		uint64_t mLine;
+
+		friend bool operator<(const Position& lhs, const Position& rhs)
+		{
+			return lhs.mDistrict != rhs.mDistrict ? lhs.mDistrict < rhs.mDistrict : lhs.mLine < rhs.mLine;
+		}
+		friend bool operator==(const Position& lhs, const Position& rhs)
+		{
+			return lhs.mDistrict == rhs.mDistrict && lhs.mLine == rhs.mLine;
+		}
+	};
+
+	// Temporary files of one partition: the names with their positions,
+	// in the order of the input, and the felons.
+	struct Partition
+	{
+		std::filesystem::path mRecords;
+		std::filesystem::path mFelons;
+	};
+
+	class Spiller;
+
+	// Returns the number of partitions needed to audit spill files of
+	// spillBytes bytes within the budget, at most kMaxFanOut.
+	size_t getFanOut(uintmax_t spillBytes) const;
+
+	// Audits the partition, and adds the files with the positions of the
+	// names to remove to runs.
+	void auditPartition(const Partition& partition, int level,
+		const std::filesystem::path& workDirectory,
+		std::vector<std::filesystem::path>& runs, Result& result) const;
+
+	// Merges the runs into a single run, and returns its path.
+	std::filesystem::path mergeRuns(std::vector<std::filesystem::path> runs,
+		const std::filesystem::path& workDirectory) const;
+
+	// Hash of name for partitioning at the given level; every level uses a
+	// different hash, so splitting a partition again divides it.
+	static size_t getPartitionHash(std::string_view name, int level);
+
+	// Hash sets take about this many bytes per byte of spill file.
+	static const size_t kMemoryPerSpillByte = 4;
+	// Maximum number of files written or merged at the same time.
+	static const size_t kMaxFanOut = 256;
+	// Partitions of a single frequent name can't be split any further.
+	static const int kMaxLevel = 4;
+
+	size_t mMemoryBudget;
+	std::filesystem::path mTempDirectory;
+};
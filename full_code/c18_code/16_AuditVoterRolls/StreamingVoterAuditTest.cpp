@@ -0,0 +1,93 @@
+#include "StreamingVoterAudit.h"
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// Writes one name per line.
+fs::path writeNames(const fs::path& file, const vector<string>& names)
+{
+	ofstream ostr(file);
+	for (const auto& name : names) {
+		ostr << name << '\n';
+	}
+	return file;
+}
+
+void printDistrict(const fs::path& file)
+{
+	cout << file.stem().string() << ":";
+	ifstream istr(file);
+	string name;
+	while (getline(istr, name)) {
+		cout << " {" << name << "}";
+	}
+	cout << endl;
+}
+
+int main()
+{
+	auto directory = fs::temp_directory_path() / "StreamingVoterAuditTest";
+	fs::create_directories(directory / "in");
+
+	vector<fs::path> districts = {
+		writeNames(directory / "in" / "Orange.txt", { "Amy Aardvark", "Bob Buffalo", "Charles Cat", "Dwayne Dog" }),
+		writeNames(directory / "in" / "Los Angeles.txt", { "Elizabeth Elephant", "Fred Flamingo", "Amy Aardvark" }),
+		writeNames(directory / "in" / "San Diego.txt", { "George Goose", "Heidi Hen", "Fred Flamingo" })
+	};
+	auto felons = writeNames(directory / "in" / "felons.txt", { "Bob Buffalo", "Charles Cat" });
+
+	StreamingVoterAudit audit(StreamingVoterAudit::kMinMemoryBudget);
+	audit.audit(districts, felons, directory / "out");
+
+	cout << "After Audit:" << endl;
+	for (const auto& district : districts) {
+		printDistrict(directory / "out" / district.filename());
+	}
+	cout << endl;
+
+	// 500000 voters, about 10 MB of spill files, audited with a budget of
+	// 1 MB, so the names are spread over many partitions.
+	mt19937 engine(42);
+	uniform_int_distribution<int> voterDist(0, 2'999'999);
+	vector<fs::path> largeDistricts;
+	for (int district = 0; district < 50; ++district) {
+		vector<string> names;
+		for (int i = 0; i < 10000; ++i) {
+			names.push_back("Voter " + to_string(voterDist(engine)));
+		}
+		largeDistricts.push_back(writeNames(directory / "in" / ("District " + to_string(district) + ".txt"), names));
+	}
+	vector<string> largeFelons;
+	for (int i = 0; i < 10000; ++i) {
+		largeFelons.push_back("Voter " + to_string(voterDist(engine)));
+	}
+	auto largeFelonsFile = writeNames(directory / "in" / "large felons.txt", largeFelons);
+
+	auto result = audit.audit(largeDistricts, largeFelonsFile, directory / "out");
+	cout << "Voters: " << result.mNumVoters << endl;
+	cout << "Removed: " << result.mNumRemoved << endl;
+	cout << "Partitions: " << result.mNumPartitions << endl;
+
+	// Districts in different directories with the same file name would
+	// overwrite each other's output, so they are rejected.
+	fs::create_directories(directory / "north");
+	vector<fs::path> sameNames = {
+		writeNames(directory / "in" / "Springfield.txt", { "Amy Aardvark" }),
+		writeNames(directory / "north" / "Springfield.txt", { "Bob Buffalo" })
+	};
+	try {
+		audit.audit(sameNames, felons, directory / "out");
+	} catch (const invalid_argument& e) {
+		cout << "Caught: " << e.what() << endl;
+	}
+
+	fs::remove_all(directory);
+	return 0;
+}
@@ -0,0 +1,210 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+// Helper returning either an element (M == 0) or a proxy for the
+// remaining M dimensions.
+template <typename T, size_t M>
+class NDGridRef;
+
+template <size_t M, typename T>
+decltype(auto) makeNDGridRef(T* data, const size_t* strides)
+{
+	if constexpr (M == 0) {
+		return *data;
+	} else {
+		return NDGridRef<T, M>(data, strides);
+	}
+}
+
+// Proxy referring to an M-dimensional slice of an NDGrid.
+// T can be const-qualified for a read-only proxy.
+template <typename T, size_t M>
+class NDGridRef
+{
+public:
+	NDGridRef(T* data, const size_t* strides) : mData(data), mStrides(strides) {}
+
+	decltype(auto) operator[](size_t x) const
+	{
+		return makeNDGridRef<M - 1>(mData + x * mStrides[0], mStrides + 1);
+	}
+
+private:
+	T* mData;
+	const size_t* mStrides;
+};
+
+// Multidimensional grid storing all its elements in one row-major buffer.
+// The offset of element (i0, i1, ..., iN-1) is the sum of ik * stride[k],
+// where the last dimension has stride 1. Every dimension can have its
+// own extent.
+//
+// grid[x][y][z] is supported through lightweight NDGridRef proxies that
+// just remember a pointer and the strides of the remaining dimensions.
+// Like the nested-vector NDGrid, operator[] doesn't verify its index;
+// use at() for a bounds-checked access.
+template <typename T, size_t N>
+class NDGrid
+{
+	static_assert(N > 0, "An NDGrid needs at least one dimension.");
+
+public:
+	using Extents = std::array<size_t, N>;
+
+	// Creates a grid with the given size in all dimensions.
+	explicit NDGrid(size_t size = kDefaultSize);
+	// Creates a grid with a separate size for every dimension.
+	explicit NDGrid(const Extents& extents);
+	virtual ~NDGrid() = default;
+
+	// Explicitly default a copy constructor and copy assignment operator.
+	NDGrid(const NDGrid& src) = default;
+	NDGrid<T, N>& operator=(const NDGrid& rhs) = default;
+
+	// Explicitly default a move constructor and move assignment operator.
+	NDGrid(NDGrid&& src) = default;
+	NDGrid<T, N>& operator=(NDGrid&& rhs) = default;
+
+	decltype(auto) operator[](size_t x)
+	{
+		return makeNDGridRef<N - 1>(mElements.data() + x * mStrides[0], mStrides.data() + 1);
+	}
+	decltype(auto) operator[](size_t x) const
+	{
+		return makeNDGridRef<N - 1>(std::as_const(mElements).data() + x * mStrides[0], mStrides.data() + 1);
+	}
+
+	// Bounds-checked access. Throws out_of_range for an invalid index.
+	T& at(const Extents& index);
+	const T& at(const Extents& index) const;
+
+	// Resizes the grid. Elements whose index is valid in both the old
+	// and the new extents keep their value.
+	void resize(size_t newSize);
+	void resize(const Extents& newExtents);
+
+	// Returns the size of the first dimension.
+	size_t getSize() const { return mExtents[0]; }
+	size_t getExtent(size_t dimension) const { return mExtents.at(dimension); }
+	const Extents& getExtents() const { return mExtents; }
+	const Extents& getStrides() const { return mStrides; }
+
+	// Access to the underlying buffer of getNumElements() elements.
+	T* data() { return mElements.data(); }
+	const T* data() const { return mElements.data(); }
+	size_t getNumElements() const { return mElements.size(); }
+
+	static const size_t kDefaultSize = 10;
+
+private:
+	static Extents computeStrides(const Extents& extents);
+
+	// The offset computation is unrolled at compile time with a fold
+	// expression over the N dimensions.
+	template <size_t... Is>
+	static size_t offsetOf(const Extents& index, const Extents& strides, std::index_sequence<Is...>)
+	{
+		return ((index[Is] * strides[Is]) + ...);
+	}
+	size_t offsetOf(const Extents& index) const
+	{
+		return offsetOf(index, mStrides, std::make_index_sequence<N>());
+	}
+
+	std::vector<T> mElements;
+	Extents mExtents{};
+	Extents mStrides{};
+};
+
+template <typename T, size_t N>
+NDGrid<T, N>::NDGrid(size_t size)
+{
+	resize(size);
+}
+
+template <typename T, size_t N>
+NDGrid<T, N>::NDGrid(const Extents& extents)
+{
+	resize(extents);
+}
+
+template <typename T, size_t N>
+typename NDGrid<T, N>::Extents NDGrid<T, N>::computeStrides(const Extents& extents)
+{
+	Extents strides;
+	size_t stride = 1;
+	for (size_t dim = N; dim-- > 0;) {
+		strides[dim] = stride;
+		stride *= extents[dim];
+	}
+	return strides;
+}
+
+template <typename T, size_t N>
+void NDGrid<T, N>::resize(size_t newSize)
+{
+	Extents newExtents;
+	newExtents.fill(newSize);
+	resize(newExtents);
+}
+
+template <typename T, size_t N>
+void NDGrid<T, N>::resize(const Extents& newExtents)
+{
+	Extents newStrides = computeStrides(newExtents);
+	size_t newNumElements = newStrides[0] * newExtents[0];
+	std::vector<T> newElements(newNumElements);
+
+	// Move the elements of the region common to the old and the new
+	// extents, one run along the last dimension at a time.
+	Extents common;
+	for (size_t dim = 0; dim < N; ++dim) {
+		common[dim] = std::min(mExtents[dim], newExtents[dim]);
+	}
+	if (std::find(begin(common), end(common), 0) == end(common)) {
+		Extents index{};
+		bool done = false;
+		while (!done) {
+			auto first = begin(mElements) + offsetOf(index);
+			std::move(first, first + common[N - 1],
+				begin(newElements) + offsetOf(index, newStrides, std::make_index_sequence<N>()));
+
+			// Advance the index like an odometer over all but the last dimension.
+			done = true;
+			for (size_t dim = N - 1; dim-- > 0;) {
+				if (++index[dim] < common[dim]) {
+					done = false;
+					break;
+				}
+				index[dim] = 0;
+			}
+		}
+	}
+
+	mElements = std::move(newElements);
+	mExtents = newExtents;
+	mStrides = newStrides;
+}
+
+template <typename T, size_t N>
+const T& NDGrid<T, N>::at(const Extents& index) const
+{
+	for (size_t dim = 0; dim < N; ++dim) {
+		if (index[dim] >= mExtents[dim]) {
+			throw std::out_of_range("");
+		}
+	}
+	return mElements[offsetOf(index)];
+}
+
+template <typename T, size_t N>
+T& NDGrid<T, N>::at(const Extents& index)
+{
+	return const_cast<T&>(std::as_const(*this).at(index));
+}
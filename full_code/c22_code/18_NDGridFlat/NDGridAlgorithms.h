@@ -0,0 +1,146 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+#include "NDGridView.h"
+
+// Parallel algorithms over all elements of an NDGridView. To run them on
+// a complete grid, pass NDGridView(grid). The elements are split, in
+// iteration order, into chunks of kNDGridChunkSize consecutive elements,
+// whatever the shape of the view, and every thread handles a contiguous
+// range of chunks. Views with at most one chunk run on the calling
+// thread only.
+//
+// The functions passed to these algorithms are called concurrently from
+// several threads, so they must not modify shared state without
+// synchronization. Exceptions thrown by them are rethrown in the
+// calling thread.
+
+// Large enough that starting a chunk costs little compared to processing
+// it. The chunks don't depend on the number of threads, so neither does
+// the result of parallelReduce().
+const size_t kNDGridChunkSize = 1 << 14;
+
+inline size_t getNumChunks(size_t numElements)
+{
+	return (numElements + kNDGridChunkSize - 1) / kNDGridChunkSize;
+}
+
+// Calls func(chunk, first, last) for every chunk of numElements elements,
+// where [first, last) are the positions of the elements of the chunk, on
+// as many threads as the hardware supports, the calling thread included.
+template <typename Func>
+void forEachChunkInParallel(size_t numElements, Func func)
+{
+	const size_t numChunks = getNumChunks(numElements);
+	const size_t numThreads = std::min<size_t>(numChunks,
+		std::max(1u, std::thread::hardware_concurrency()));
+
+	std::vector<std::exception_ptr> errors(numThreads);
+	auto worker = [&](size_t threadIndex) {
+		try {
+			const size_t firstChunk = numChunks * threadIndex / numThreads;
+			const size_t lastChunk = numChunks * (threadIndex + 1) / numThreads;
+			for (size_t chunk = firstChunk; chunk < lastChunk; ++chunk) {
+				func(chunk, chunk * kNDGridChunkSize,
+					std::min(numElements, (chunk + 1) * kNDGridChunkSize));
+			}
+		} catch (...) {
+			errors[threadIndex] = std::current_exception();
+		}
+	};
+
+	std::vector<std::thread> threads;
+	for (size_t i = 1; i < numThreads; ++i) {
+		threads.emplace_back(worker, i);
+	}
+	if (numThreads > 0) {
+		worker(0);
+	}
+	for (auto& t : threads) {
+		t.join();
+	}
+
+	for (auto& error : errors) {
+		if (error) {
+			std::rethrow_exception(error);
+		}
+	}
+}
+
+// Calls func(element) for every element of the view, in parallel.
+template <typename T, size_t M, typename Func>
+void parallelForEachElement(const NDGridView<T, M>& view, Func func)
+{
+	forEachChunkInParallel(view.getNumElements(), [&](size_t, size_t first, size_t last) {
+		std::for_each(view.iteratorAt(first), view.iteratorAt(last), func);
+	});
+}
+
+// Stores func(element) in the corresponding element of out, for every
+// element of in, in parallel.
+// Throws invalid_argument if the views have different extents.
+template <typename T, typename U, size_t M, typename Func>
+void parallelTransform(const NDGridView<T, M>& in, const NDGridView<U, M>& out, Func func)
+{
+	if (in.getExtents() != out.getExtents()) {
+		throw std::invalid_argument("Views have different extents.");
+	}
+	forEachChunkInParallel(in.getNumElements(), [&](size_t, size_t first, size_t last) {
+		std::transform(in.iteratorAt(first), in.iteratorAt(last), out.iteratorAt(first), func);
+	});
+}
+
+// Reduces all elements of the view in parallel: every element is mapped
+// to a value with transformOp(element), and the values are combined with
+// reduceOp(value1, value2). init must be an identity element of reduceOp
+// (for example 0 for addition), because it's used as the start value of
+// every chunk. The chunk results are combined in order, so the result
+// doesn't depend on the number of threads, even for floating-point
+// addition.
+template <typename T, size_t M, typename Value, typename ReduceOp, typename TransformOp>
+Value parallelReduce(const NDGridView<T, M>& view, Value init, ReduceOp reduceOp,
+	TransformOp transformOp)
+{
+	// Optionals instead of plain Values, because concurrently writing
+	// elements of a vector<bool> is not safe.
+	const size_t numElements = view.getNumElements();
+	std::vector<std::optional<Value>> partials(getNumChunks(numElements));
+	forEachChunkInParallel(numElements, [&](size_t chunk, size_t first, size_t last) {
+		Value partial = init;
+		for (auto it = view.iteratorAt(first), end = view.iteratorAt(last); it != end; ++it) {
+			partial = reduceOp(partial, transformOp(*it));
+		}
+		partials[chunk] = partial;
+	});
+
+	Value result = init;
+	for (const auto& partial : partials) {
+		result = reduceOp(result, *partial);
+	}
+	return result;
+}
+
+// Computes every element of out as func(in, index), in parallel, where
+// index is a std::array with the index of the element. func can read any
+// element of in, such as the neighbors of index for a stencil.
+// in and out must not overlap.
+// Throws invalid_argument if the views have different extents.
+template <typename T, typename U, size_t M, typename Func>
+void parallelStencilApply(const NDGridView<T, M>& in, const NDGridView<U, M>& out, Func func)
+{
+	if (in.getExtents() != out.getExtents()) {
+		throw std::invalid_argument("Views have different extents.");
+	}
+	forEachChunkInParallel(in.getNumElements(), [&](size_t, size_t first, size_t last) {
+		for (auto it = out.iteratorAt(first), end = out.iteratorAt(last); it != end; ++it) {
+			*it = func(in, it.getIndex());
+		}
+	});
+}
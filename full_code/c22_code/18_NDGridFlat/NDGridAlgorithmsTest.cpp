@@ -0,0 +1,59 @@
+#include "NDGrid.h"
+#include "NDGridView.h"
+#include "NDGridAlgorithms.h"
+#include <iostream>
+
+using namespace std;
+
+int main()
+{
+	NDGrid<double, 3> volume({ 64, 64, 64 });
+	NDGridView all(volume);
+
+	// Initialize all elements in parallel.
+	parallelForEachElement(all, [](double& element) { element = 1.0; });
+
+	// Store the halves of all elements in another grid.
+	NDGrid<double, 3> halves(volume.getExtents());
+	parallelTransform(all, NDGridView(halves), [](double element) { return element / 2; });
+
+	auto plus = [](double a, double b) { return a + b; };
+	auto identity = [](double element) { return element; };
+	cout << "Sum of halves: " << parallelReduce(NDGridView(halves), 0.0, plus, identity) << endl;
+	cout << "Sum of one plane: " << parallelReduce(all.fix(2, 0), 0.0, plus, identity) << endl;
+
+	// Count the neighbors of every element with a 7-point stencil.
+	NDGrid<int, 3> neighbors(volume.getExtents());
+	parallelStencilApply(all, NDGridView(neighbors),
+		[](const NDGridView<double, 3>& in, const array<size_t, 3>& index) {
+			int count = 0;
+			for (size_t dim = 0; dim < 3; ++dim) {
+				count += (index[dim] > 0);
+				count += (index[dim] + 1 < in.getExtent(dim));
+			}
+			return count;
+		});
+	cout << "Neighbors of corner: " << neighbors[0][0][0]
+		<< ", of edge: " << neighbors[0][0][5]
+		<< ", of interior: " << neighbors[5][5][5] << endl;
+
+	// A 1-D grid and a grid with a thin first dimension are split into
+	// chunks of consecutive elements, like any other shape.
+	NDGrid<double, 1> line(1'000'003);
+	parallelForEachElement(NDGridView(line), [](double& element) { element = 0.5; });
+	cout << "Sum of line: " << parallelReduce(NDGridView(line), 0.0, plus, identity) << endl;
+
+	NDGrid<int, 2> thin({ 2, 500'001 });
+	for (size_t x = 0; x < 2; ++x) {
+		for (size_t y = 0; y < 500'001; ++y) {
+			thin[x][y] = static_cast<int>(x + 1);
+		}
+	}
+	// Transposed, so the chunks step through a strided view.
+	auto transposed = NDGridView(thin).transpose({ 1, 0 });
+	auto add = [](long long a, long long b) { return a + b; };
+	cout << "Sum of thin grid: " << parallelReduce(transposed, 0LL, add, [](int element) { return element; })
+		<< " (expected " << 3LL * 500'001 << ")" << endl;
+
+	return 0;
+}
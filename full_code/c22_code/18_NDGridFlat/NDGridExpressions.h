@@ -0,0 +1,269 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include "NDGrid.h"
+#include "SimdPack.h"
+
+// Element-wise arithmetic on NDGrids of arithmetic types, implemented with
+// expression templates. An expression such as
+//     fusedMultiplyAdd(a, b, c) / 2.0
+// doesn't compute anything. It builds a small object describing the
+// computation, which assign() or evaluate() then executes in a single
+// pass over the elements, without temporary grids. The loop processes a
+// whole SIMD pack (see SimdPack.h) per iteration, and uses scalar
+// operations for the remaining elements.
+//
+// Supported are + - * / between grids, expressions, and scalars,
+// fusedMultiplyAdd(a, b, c), clampElements(a, low, high), the comparisons
+// < <= > >= == != producing masks, and where(mask, a, b) to select
+// between two expressions. A mask can be evaluated into an NDMask, which
+// stores 0 or 1 per element.
+//
+// Expressions refer to the grids they use; they must not outlive them.
+
+template <size_t N>
+using NDMask = NDGrid<unsigned char, N>;
+
+// Base class of all expressions, using the curiously recurring template
+// pattern to get at the actual expression type.
+template <typename Derived>
+class NDGridExpression
+{
+public:
+	const Derived& derived() const { return static_cast<const Derived&>(*this); }
+};
+
+// Expression reading the elements of a grid.
+template <typename T, size_t N>
+class NDGridLeaf : public NDGridExpression<NDGridLeaf<T, N>>
+{
+	static_assert(std::is_arithmetic_v<T>, "Expressions need an arithmetic element type.");
+
+public:
+	using value_type = T;
+	static const size_t kDimensions = N;
+	static const bool kIsMask = false;
+
+	explicit NDGridLeaf(const NDGrid<T, N>& grid)
+		: mData(grid.data()), mExtents(grid.getExtents()) {}
+
+	const std::array<size_t, N>& getExtents() const { return mExtents; }
+
+	template <typename Pack>
+	Pack eval(size_t i) const { return Pack::load(mData + i); }
+
+private:
+	const T* mData;
+	std::array<size_t, N> mExtents;
+};
+
+// Expression with the same scalar value for every element. It takes the
+// element type and the extents of the other operands.
+template <typename S>
+class ScalarLeaf : public NDGridExpression<ScalarLeaf<S>>
+{
+public:
+	explicit ScalarLeaf(S value) : mValue(value) {}
+
+	template <typename Pack>
+	Pack eval(size_t) const
+	{
+		return Pack::broadcast(static_cast<typename Pack::value_type>(mValue));
+	}
+
+private:
+	S mValue;
+};
+
+template <typename T>
+struct IsScalarLeaf : std::false_type {};
+template <typename S>
+struct IsScalarLeaf<ScalarLeaf<S>> : std::true_type {};
+
+// Finds the first operand that is not a scalar; it determines the element
+// type, the number of dimensions, and the extents of an expression.
+template <typename First, typename... Rest>
+constexpr auto firstGridOperand(const First& first, const Rest&... rest)
+	-> decltype(auto)
+{
+	if constexpr (IsScalarLeaf<First>::value) {
+		return firstGridOperand(rest...);
+	} else {
+		return (first);
+	}
+}
+
+template <typename... Args>
+using FirstGridOperand = std::decay_t<decltype(firstGridOperand(std::declval<const Args&>()...))>;
+
+// Expression applying Op to the results of its operands. Op is a class
+// with a static template member function apply() that works on packs.
+template <typename Op, typename... Args>
+class NDGridNode : public NDGridExpression<NDGridNode<Op, Args...>>
+{
+public:
+	using value_type = typename FirstGridOperand<Args...>::value_type;
+	static const size_t kDimensions = FirstGridOperand<Args...>::kDimensions;
+	static const bool kIsMask = Op::kIsMask;
+
+	// Throws invalid_argument if the grid operands have different extents.
+	explicit NDGridNode(const Args&... args)
+		: mArgs(args...)
+		, mExtents(firstGridOperand(args...).getExtents())
+	{
+		auto verify = [this](const auto& arg) {
+			using ArgType = std::decay_t<decltype(arg)>;
+			if constexpr (!IsScalarLeaf<ArgType>::value) {
+				static_assert(std::is_same_v<typename ArgType::value_type, value_type>,
+					"All grids in an expression need the same element type.");
+				if (arg.getExtents() != mExtents) {
+					throw std::invalid_argument("Grids have different extents.");
+				}
+			}
+		};
+		(verify(args), ...);
+	}
+
+	const std::array<size_t, kDimensions>& getExtents() const { return mExtents; }
+
+	template <typename Pack>
+	decltype(auto) eval(size_t i) const
+	{
+		return std::apply([i](const auto&... args) {
+			return Op::apply(args.template eval<Pack>(i)...);
+		}, mArgs);
+	}
+
+private:
+	std::tuple<Args...> mArgs;
+	std::array<size_t, kDimensions> mExtents;
+};
+
+// Converts the operands of the operators and functions below to
+// expressions: grids become leaves, scalars become scalar leaves, and
+// expressions stay as they are.
+template <typename T, size_t N>
+NDGridLeaf<T, N> toExpression(const NDGrid<T, N>& grid) { return NDGridLeaf<T, N>(grid); }
+
+template <typename Derived>
+const Derived& toExpression(const NDGridExpression<Derived>& expression) { return expression.derived(); }
+
+template <typename S, typename = std::enable_if_t<std::is_arithmetic_v<S>>>
+ScalarLeaf<S> toExpression(S value) { return ScalarLeaf<S>(value); }
+
+template <typename T>
+struct IsGridOperand : std::is_base_of<NDGridExpression<T>, T> {};
+template <typename T, size_t N>
+struct IsGridOperand<NDGrid<T, N>> : std::true_type {};
+
+// The operators and functions are only available if at least one of the
+// operands is a grid or an expression, and all others are scalars.
+template <typename... Args>
+constexpr bool kIsGridExpression = (IsGridOperand<std::decay_t<Args>>::value || ...) &&
+	((IsGridOperand<std::decay_t<Args>>::value || std::is_arithmetic_v<std::decay_t<Args>>) && ...);
+
+template <typename Op, typename... Args>
+auto makeNode(const Args&... args)
+{
+	return NDGridNode<Op, std::decay_t<decltype(toExpression(args))>...>(toExpression(args)...);
+}
+
+// The operations on packs.
+struct AddOp { static const bool kIsMask = false; template <typename P> static P apply(P a, P b) { return a + b; } };
+struct SubOp { static const bool kIsMask = false; template <typename P> static P apply(P a, P b) { return a - b; } };
+struct MulOp { static const bool kIsMask = false; template <typename P> static P apply(P a, P b) { return a * b; } };
+struct DivOp { static const bool kIsMask = false; template <typename P> static P apply(P a, P b) { return a / b; } };
+struct FmaOp { static const bool kIsMask = false; template <typename P> static P apply(P a, P b, P c) { return fusedMultiplyAdd(a, b, c); } };
+struct ClampOp { static const bool kIsMask = false; template <typename P> static P apply(P a, P low, P high) { return minimum(maximum(a, low), high); } };
+struct LessOp { static const bool kIsMask = true; template <typename P> static auto apply(P a, P b) { return a < b; } };
+struct LessEqualOp { static const bool kIsMask = true; template <typename P> static auto apply(P a, P b) { return a <= b; } };
+struct GreaterOp { static const bool kIsMask = true; template <typename P> static auto apply(P a, P b) { return a > b; } };
+struct GreaterEqualOp { static const bool kIsMask = true; template <typename P> static auto apply(P a, P b) { return a >= b; } };
+struct EqualOp { static const bool kIsMask = true; template <typename P> static auto apply(P a, P b) { return a == b; } };
+struct NotEqualOp { static const bool kIsMask = true; template <typename P> static auto apply(P a, P b) { return a != b; } };
+struct WhereOp { static const bool kIsMask = false; template <typename M, typename P> static P apply(M mask, P a, P b) { return where(mask, a, b); } };
+
+template <typename L, typename R, typename = std::enable_if_t<kIsGridExpression<L, R>>>
+auto operator+(const L& lhs, const R& rhs) { return makeNode<AddOp>(lhs, rhs); }
+template <typename L, typename R, typename = std::enable_if_t<kIsGridExpression<L, R>>>
+auto operator-(const L& lhs, const R& rhs) { return makeNode<SubOp>(lhs, rhs); }
+template <typename L, typename R, typename = std::enable_if_t<kIsGridExpression<L, R>>>
+auto operator*(const L& lhs, const R& rhs) { return makeNode<MulOp>(lhs, rhs); }
+template <typename L, typename R, typename = std::enable_if_t<kIsGridExpression<L, R>>>
+auto operator/(const L& lhs, const R& rhs) { return makeNode<DivOp>(lhs, rhs); }
+
+template <typename L, typename R, typename = std::enable_if_t<kIsGridExpression<L, R>>>
+auto operator<(const L& lhs, const R& rhs) { return makeNode<LessOp>(lhs, rhs); }
+template <typename L, typename R, typename = std::enable_if_t<kIsGridExpression<L, R>>>
+auto operator<=(const L& lhs, const R& rhs) { return makeNode<LessEqualOp>(lhs, rhs); }
+template <typename L, typename R, typename = std::enable_if_t<kIsGridExpression<L, R>>>
+auto operator>(const L& lhs, const R& rhs) { return makeNode<GreaterOp>(lhs, rhs); }
+template <typename L, typename R, typename = std::enable_if_t<kIsGridExpression<L, R>>>
+auto operator>=(const L& lhs, const R& rhs) { return makeNode<GreaterEqualOp>(lhs, rhs); }
+template <typename L, typename R, typename = std::enable_if_t<kIsGridExpression<L, R>>>
+auto operator==(const L& lhs, const R& rhs) { return makeNode<EqualOp>(lhs, rhs); }
+template <typename L, typename R, typename = std::enable_if_t<kIsGridExpression<L, R>>>
+auto operator!=(const L& lhs, const R& rhs) { return makeNode<NotEqualOp>(lhs, rhs); }
+
+// Computes a * b + c, with a fused multiply-add instruction if available.
+template <typename A, typename B, typename C, typename = std::enable_if_t<kIsGridExpression<A, B, C>>>
+auto fusedMultiplyAdd(const A& a, const B& b, const C& c) { return makeNode<FmaOp>(a, b, c); }
+
+// Limits every element to the range [low, high]. NaN elements become low,
+// in the SIMD packs and in the scalar remainder alike.
+template <typename A, typename L, typename H, typename = std::enable_if_t<kIsGridExpression<A, L, H>>>
+auto clampElements(const A& a, const L& low, const H& high) { return makeNode<ClampOp>(a, low, high); }
+
+// Selects the element of a where mask is set, and of b elsewhere.
+// mask must be a comparison expression.
+template <typename M, typename A, typename B, typename = std::enable_if_t<kIsGridExpression<A, B>>>
+auto where(const NDGridExpression<M>& mask, const A& a, const B& b)
+{
+	static_assert(M::kIsMask, "The first argument of where() must be a comparison.");
+	return makeNode<WhereOp>(mask.derived(), a, b);
+}
+
+// Evaluates expression into dest, in one pass over all elements. dest
+// can be one of the grids used in the expression. A comparison must be
+// evaluated into an NDMask, any other expression into a grid with the
+// element type of the expression.
+// Throws invalid_argument if dest has different extents.
+template <typename T, size_t N, typename Expr>
+void assign(NDGrid<T, N>& dest, const NDGridExpression<Expr>& expression)
+{
+	const Expr& expr = expression.derived();
+	static_assert(Expr::kDimensions == N, "The expression has a different number of dimensions.");
+	static_assert(Expr::kIsMask ? std::is_same_v<T, unsigned char> : std::is_same_v<T, typename Expr::value_type>,
+		"Evaluate comparisons into an NDMask, and other expressions into a grid of their element type.");
+	if (dest.getExtents() != expr.getExtents()) {
+		throw std::invalid_argument("Grids have different extents.");
+	}
+
+	using Pack = SimdPackFor_t<typename Expr::value_type>;
+	using Scalar = ScalarPack<typename Expr::value_type>;
+	const size_t numElements = dest.getNumElements();
+	T* out = dest.data();
+	size_t i = 0;
+	for (; i + Pack::kSize <= numElements; i += Pack::kSize) {
+		expr.template eval<Pack>(i).store(out + i);
+	}
+	for (; i < numElements; ++i) {
+		expr.template eval<Scalar>(i).store(out + i);
+	}
+}
+
+// Returns a new grid, or a new NDMask for a comparison, with the result of
+// the expression.
+template <typename Expr>
+auto evaluate(const NDGridExpression<Expr>& expression)
+{
+	using ResultType = std::conditional_t<Expr::kIsMask, unsigned char, typename Expr::value_type>;
+	NDGrid<ResultType, Expr::kDimensions> result(expression.derived().getExtents());
+	assign(result, expression);
+	return result;
+}
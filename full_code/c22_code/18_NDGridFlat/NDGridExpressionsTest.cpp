@@ -0,0 +1,67 @@
+#include "NDGrid.h"
+#include "NDGridExpressions.h"
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+#include <limits>
+
+using namespace std;
+
+int main()
+{
+	// 7 x 9 elements, so the last pack of every width is incomplete.
+	NDGrid<double, 2> a({ 7, 9 });
+	NDGrid<double, 2> b(a.getExtents());
+	NDGrid<double, 2> c(a.getExtents());
+	for (size_t i = 0; i < a.getNumElements(); ++i) {
+		a.data()[i] = static_cast<double>(i);
+		b.data()[i] = 0.5;
+		c.data()[i] = static_cast<double>(i % 5);
+	}
+
+	// Evaluated in one pass, without temporary grids.
+	auto result = evaluate(fusedMultiplyAdd(a, b, c) - 1.0);
+	auto clamped = evaluate(clampElements(a * 2.0, 10.0, 50.0));
+	auto larger = evaluate(a > c * 4.0);
+	auto selected = evaluate(where(a < 20.0, a, 0.0 - a));
+
+	size_t mismatches = 0;
+	for (size_t i = 0; i < a.getNumElements(); ++i) {
+		double x = a.data()[i];
+		double z = c.data()[i];
+		mismatches += (result.data()[i] != x * 0.5 + z - 1.0);
+		mismatches += (clamped.data()[i] != min(max(x * 2.0, 10.0), 50.0));
+		mismatches += (larger.data()[i] != (x > z * 4.0));
+		mismatches += (selected.data()[i] != (x < 20.0 ? x : -x));
+	}
+	cout << "Elements per pack: " << SimdPackFor_t<double>::kSize
+		<< ", mismatches with scalar loop: " << mismatches << endl;
+
+	// NaN clamps to the lower bound, whether it is in a full pack or in
+	// the scalar remainder.
+	NDGrid<double, 1> withNaN(7);
+	for (size_t i = 0; i < withNaN.getNumElements(); ++i) {
+		withNaN[i] = numeric_limits<double>::quiet_NaN();
+	}
+	auto clampedNaN = evaluate(clampElements(withNaN, -1.0, 1.0));
+	size_t lowerBounds = count(clampedNaN.data(), clampedNaN.data() + clampedNaN.getNumElements(), -1.0);
+	cout << "NaN elements clamped to the lower bound: " << lowerBounds << " of 7" << endl;
+
+	// Assign into an existing grid, which can be one of the operands.
+	assign(a, a / 2.0 + 1.0);
+	cout << "a[6][8] = " << a[6][8] << endl;
+
+	// Integer grids use the scalar pack.
+	NDGrid<int, 1> counts(5);
+	assign(counts, counts + 3);
+	cout << "counts[4] = " << counts[4] << endl;
+
+	try {
+		NDGrid<double, 2> other({ 3, 3 });
+		assign(a, a + other);
+	} catch (const invalid_argument& e) {
+		cout << "Caught: " << e.what() << endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,40 @@
+#include "NDGrid.h"
+#include <iostream>
+
+using namespace std;
+
+int main()
+{
+	NDGrid<int, 3> my3DGrid;
+	my3DGrid[2][1][2] = 5;
+	my3DGrid[1][1][1] = 5;
+
+	cout << my3DGrid[2][1][2] << endl;
+
+	// Every dimension can have its own size.
+	NDGrid<double, 3> volume({ 4, 3, 2 });
+	volume[3][2][1] = 1.5;
+	volume.at({ 0, 1, 0 }) = 2.5;
+	cout << "Extents: " << volume.getExtent(0) << "x" << volume.getExtent(1)
+		<< "x" << volume.getExtent(2) << ", " << volume.getNumElements()
+		<< " elements in one buffer" << endl;
+
+	// Resizing keeps the elements that are still inside the grid.
+	volume.resize({ 5, 2, 2 });
+	cout << "After resize: " << volume[0][1][0] << endl;
+
+	try {
+		volume.at({ 4, 2, 0 });
+	} catch (const out_of_range&) {
+		cout << "Index out of range." << endl;
+	}
+
+	const auto& constVolume = volume;
+	cout << constVolume[0][1][0] << endl;
+
+	NDGrid<int, 1> line(3);
+	line[2] = 7;
+	cout << line[2] << endl;
+
+	return 0;
+}
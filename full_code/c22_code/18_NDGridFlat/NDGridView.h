@@ -0,0 +1,291 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include "NDGrid.h"
+
+// Forward iterator visiting the elements of an M-dimensional strided
+// view, with the last dimension varying fastest.
+template <typename T, size_t M>
+class NDGridViewIterator
+{
+public:
+	using iterator_category = std::forward_iterator_tag;
+	using value_type = std::remove_cv_t<T>;
+	using difference_type = std::ptrdiff_t;
+	using pointer = T*;
+	using reference = T&;
+
+	NDGridViewIterator() = default;
+	// Iterator to the element with the given position in iteration order.
+	NDGridViewIterator(T* data, const std::array<size_t, M>& extents,
+		const std::array<size_t, M>& strides, size_t position)
+		: mData(data), mExtents(extents), mStrides(strides), mPosition(position)
+	{
+		// Split the position into an index, last dimension fastest. If an
+		// extent is 0, there are no elements, and position is 0.
+		for (size_t dim = M; dim-- > 1;) {
+			if (mExtents[dim] != 0) {
+				mIndex[dim] = position % mExtents[dim];
+				position /= mExtents[dim];
+			}
+		}
+		mIndex[0] = position;
+		for (size_t dim = 0; dim < M; ++dim) {
+			mOffset += mIndex[dim] * mStrides[dim];
+		}
+	}
+
+	reference operator*() const { return mData[mOffset]; }
+	pointer operator->() const { return mData + mOffset; }
+
+	NDGridViewIterator& operator++()
+	{
+		++mPosition;
+		// Advance the index like an odometer, adjusting the offset
+		// incrementally instead of recomputing it. The offset is an
+		// integer, not a pointer, because past the last element it can
+		// be beyond the end of the buffer.
+		for (size_t dim = M; dim-- > 0;) {
+			mOffset += mStrides[dim];
+			if (++mIndex[dim] < mExtents[dim] || dim == 0) {
+				break;
+			}
+			mOffset -= mIndex[dim] * mStrides[dim];
+			mIndex[dim] = 0;
+		}
+		return *this;
+	}
+	NDGridViewIterator operator++(int) { auto old = *this; ++*this; return old; }
+
+	// Index of the element, and its position in iteration order.
+	const std::array<size_t, M>& getIndex() const { return mIndex; }
+	size_t getPosition() const { return mPosition; }
+
+	bool operator==(const NDGridViewIterator& rhs) const { return mPosition == rhs.mPosition; }
+	bool operator!=(const NDGridViewIterator& rhs) const { return mPosition != rhs.mPosition; }
+
+private:
+	T* mData = nullptr;
+	size_t mOffset = 0;
+	std::array<size_t, M> mExtents{};
+	std::array<size_t, M> mStrides{};
+	std::array<size_t, M> mIndex{};
+	size_t mPosition = 0;
+};
+
+// Non-owning M-dimensional view of the elements of an NDGrid. A view is
+// a pointer to its first element plus an extent and a stride for every
+// dimension, so sub-blocks, strided slices, fixed-index slices, and
+// transpositions are all views themselves, and creating them never
+// copies any elements.
+//
+// T can be const-qualified for a read-only view. A view is invalidated
+// when the grid it refers to is destroyed or resized.
+template <typename T, size_t M>
+class NDGridView
+{
+	static_assert(M > 0, "An NDGridView needs at least one dimension.");
+
+public:
+	using Extents = std::array<size_t, M>;
+	using iterator = NDGridViewIterator<T, M>;
+
+	NDGridView(T* data, const Extents& extents, const Extents& strides)
+		: mData(data), mExtents(extents), mStrides(strides) {}
+
+	// Views of a complete grid.
+	template <typename U, typename = std::enable_if_t<std::is_same_v<std::remove_const_t<T>, U>>>
+	NDGridView(NDGrid<U, M>& grid)
+		: NDGridView(grid.data(), grid.getExtents(), grid.getStrides()) {}
+	template <typename U, typename = std::enable_if_t<std::is_same_v<T, const U>>>
+	NDGridView(const NDGrid<U, M>& grid)
+		: NDGridView(grid.data(), grid.getExtents(), grid.getStrides()) {}
+
+	decltype(auto) operator[](size_t x) const
+	{
+		return makeNDGridRef<M - 1>(mData + x * mStrides[0], mStrides.data() + 1);
+	}
+
+	// Bounds-checked access. Throws out_of_range for an invalid index.
+	T& at(const Extents& index) const;
+
+	// Returns the view of the block starting at start, with the given
+	// extents, taking every step-th element along every dimension.
+	// Throws out_of_range if the block doesn't fit in this view.
+	NDGridView<T, M> slice(const Extents& start, const Extents& extents,
+		const Extents& steps) const;
+
+	// Returns the view of the contiguous block starting at start, with
+	// the given extents. Throws out_of_range if the block doesn't fit.
+	NDGridView<T, M> subBlock(const Extents& start, const Extents& extents) const;
+
+	// Returns the (M-1)-dimensional view of all elements with the given
+	// index along axis, for example a 2-D plane of a 3-D grid.
+	// Throws out_of_range for an invalid axis or index.
+	NDGridView<T, M - 1> fix(size_t axis, size_t index) const;
+
+	// Returns a view with permuted axes: dimension k of the result is
+	// dimension permutation[k] of this view. transpose({ 1, 0 }) swaps
+	// the two axes of a 2-D view.
+	// Throws invalid_argument if permutation is not a permutation of 0..M-1.
+	NDGridView<T, M> transpose(const Extents& permutation) const;
+
+	iterator begin() const { return iterator(mData, mExtents, mStrides, 0); }
+	iterator end() const { return iterator(mData, mExtents, mStrides, getNumElements()); }
+	// Iterator to the element with the given position in iteration order,
+	// from 0 for begin() to getNumElements() for end(). Doesn't verify
+	// the position.
+	iterator iteratorAt(size_t position) const { return iterator(mData, mExtents, mStrides, position); }
+
+	size_t getExtent(size_t dimension) const { return mExtents.at(dimension); }
+	const Extents& getExtents() const { return mExtents; }
+	const Extents& getStrides() const { return mStrides; }
+	size_t getNumElements() const;
+
+private:
+	T* mData;
+	Extents mExtents;
+	Extents mStrides;
+};
+
+// Deduction guides to write NDGridView view(grid).
+template <typename T, size_t N>
+NDGridView(NDGrid<T, N>&) -> NDGridView<T, N>;
+template <typename T, size_t N>
+NDGridView(const NDGrid<T, N>&) -> NDGridView<const T, N>;
+
+template <typename T, size_t M>
+T& NDGridView<T, M>::at(const Extents& index) const
+{
+	size_t offset = 0;
+	for (size_t dim = 0; dim < M; ++dim) {
+		if (index[dim] >= mExtents[dim]) {
+			throw std::out_of_range("");
+		}
+		offset += index[dim] * mStrides[dim];
+	}
+	return mData[offset];
+}
+
+template <typename T, size_t M>
+size_t NDGridView<T, M>::getNumElements() const
+{
+	size_t result = 1;
+	for (size_t extent : mExtents) {
+		result *= extent;
+	}
+	return result;
+}
+
+template <typename T, size_t M>
+NDGridView<T, M> NDGridView<T, M>::slice(const Extents& start,
+	const Extents& extents, const Extents& steps) const
+{
+	T* first = mData;
+	Extents strides;
+	for (size_t dim = 0; dim < M; ++dim) {
+		if (steps[dim] == 0) {
+			throw std::out_of_range("");
+		}
+		// The last element of the slice must be inside this view.
+		if (extents[dim] > 0 &&
+			(start[dim] >= mExtents[dim] ||
+			(extents[dim] - 1) * steps[dim] >= mExtents[dim] - start[dim])) {
+			throw std::out_of_range("");
+		}
+		first += start[dim] * mStrides[dim];
+		strides[dim] = mStrides[dim] * steps[dim];
+	}
+	return NDGridView<T, M>(first, extents, strides);
+}
+
+template <typename T, size_t M>
+NDGridView<T, M> NDGridView<T, M>::subBlock(const Extents& start, const Extents& extents) const
+{
+	Extents steps;
+	steps.fill(1);
+	return slice(start, extents, steps);
+}
+
+template <typename T, size_t M>
+NDGridView<T, M - 1> NDGridView<T, M>::fix(size_t axis, size_t index) const
+{
+	static_assert(M > 1, "Cannot fix the only dimension of a view.");
+
+	if (axis >= M || index >= mExtents[axis]) {
+		throw std::out_of_range("");
+	}
+	std::array<size_t, M - 1> extents, strides;
+	for (size_t dim = 0, out = 0; dim < M; ++dim) {
+		if (dim != axis) {
+			extents[out] = mExtents[dim];
+			strides[out] = mStrides[dim];
+			++out;
+		}
+	}
+	return NDGridView<T, M - 1>(mData + index * mStrides[axis], extents, strides);
+}
+
+template <typename T, size_t M>
+NDGridView<T, M> NDGridView<T, M>::transpose(const Extents& permutation) const
+{
+	Extents extents, strides;
+	std::array<bool, M> used{};
+	for (size_t dim = 0; dim < M; ++dim) {
+		size_t from = permutation[dim];
+		if (from >= M || used[from]) {
+			throw std::invalid_argument("Not a permutation of the axes.");
+		}
+		used[from] = true;
+		extents[dim] = mExtents[from];
+		strides[dim] = mStrides[from];
+	}
+	return NDGridView<T, M>(mData, extents, strides);
+}
+
+// Calls func(block) for every block of the view, where block is a
+// sub-block view of at most blockExtents elements. Blocks are visited
+// with the last dimension varying fastest; blocks at the upper edges of
+// the view can be smaller than blockExtents.
+// Walking a grid block by block keeps the neighborhood of every element
+// in the cache, which matters for stencils that also read along the
+// slow dimensions.
+// Throws invalid_argument if one of the block extents is 0.
+template <typename T, size_t M, typename Func>
+void forEachBlock(const NDGridView<T, M>& view, const std::array<size_t, M>& blockExtents, Func func)
+{
+	for (size_t dim = 0; dim < M; ++dim) {
+		if (blockExtents[dim] == 0) {
+			throw std::invalid_argument("Block extents must be positive.");
+		}
+		if (view.getExtent(dim) == 0) {
+			return;
+		}
+	}
+
+	std::array<size_t, M> start{};
+	bool done = false;
+	while (!done) {
+		std::array<size_t, M> extents;
+		for (size_t dim = 0; dim < M; ++dim) {
+			extents[dim] = std::min(blockExtents[dim], view.getExtent(dim) - start[dim]);
+		}
+		func(view.subBlock(start, extents));
+
+		// Advance to the next block like an odometer.
+		done = true;
+		for (size_t dim = M; dim-- > 0;) {
+			start[dim] += blockExtents[dim];
+			if (start[dim] < view.getExtent(dim)) {
+				done = false;
+				break;
+			}
+			start[dim] = 0;
+		}
+	}
+}
@@ -0,0 +1,73 @@
+#include "NDGrid.h"
+#include "NDGridView.h"
+#include <algorithm>
+#include <numeric>
+#include <iostream>
+
+using namespace std;
+
+// Prints a 2-D view, one line per value of the first index.
+template <typename T>
+void printPlane(const NDGridView<T, 2>& plane)
+{
+	for (size_t x = 0; x < plane.getExtent(0); ++x) {
+		for (size_t y = 0; y < plane.getExtent(1); ++y) {
+			cout << plane[x][y] << "\t";
+		}
+		cout << endl;
+	}
+	cout << endl;
+}
+
+int main()
+{
+	NDGrid<int, 3> volume({ 2, 3, 4 });
+	NDGridView all(volume);
+	iota(begin(all), end(all), 0);
+
+	// The plane with x == 1 is a view on the grid; nothing is copied.
+	auto plane = all.fix(0, 1);
+	cout << "Plane x == 1:" << endl;
+	printPlane(plane);
+
+	// Writing through a view modifies the grid.
+	plane[0][0] = -1;
+	cout << "volume[1][0][0] = " << volume[1][0][0] << endl << endl;
+
+	cout << "Transposed plane:" << endl;
+	printPlane(plane.transpose({ 1, 0 }));
+
+	cout << "Every second column of the plane:" << endl;
+	printPlane(plane.slice({ 0, 0 }, { 3, 2 }, { 1, 2 }));
+
+	// A plane along another axis, and a sub-block of it.
+	auto zPlane = all.fix(2, 3);
+	cout << "Plane z == 3, rows 1-2:" << endl;
+	printPlane(zPlane.subBlock({ 0, 1 }, { 2, 2 }));
+
+	// Views work with Standard Library algorithms.
+	auto column = all.fix(0, 0).fix(1, 2);
+	cout << "Sum of volume[0][*][2]: " << accumulate(begin(column), end(column), 0) << endl;
+
+	// Read-only view of a const grid.
+	const auto& constVolume = volume;
+	NDGridView constView(constVolume);
+	cout << "Maximum: " << *max_element(begin(constView), end(constView)) << endl;
+
+	// Process the grid in blocks of at most 1x2x2 elements.
+	size_t numBlocks = 0;
+	forEachBlock(all, { 1, 2, 2 }, [&numBlocks](auto block) {
+		++numBlocks;
+		fill(begin(block), end(block), static_cast<int>(numBlocks));
+	});
+	cout << "Number of blocks: " << numBlocks << endl;
+	printPlane(all.fix(0, 1));
+
+	try {
+		all.subBlock({ 1, 0, 0 }, { 2, 1, 1 });
+	} catch (const out_of_range&) {
+		cout << "Sub-block out of range." << endl;
+	}
+
+	return 0;
+}
@@ -0,0 +1,263 @@
+#pragma once
+
+#include <cstddef>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+// A pack holds as many values of type T as fit in one SIMD register, and
+// applies every operation to all of them at once. All packs have the same
+// interface, so code written against it works with AVX2, with SSE2, and
+// with the scalar fallback:
+//   load(), store(), broadcast()      memory access and scalar splat
+//   + - * /                           element-wise arithmetic
+//   fusedMultiplyAdd(a, b, c)         a * b + c
+//   minimum(a, b), maximum(a, b)      b if either value is NaN, as with
+//                                     the SSE and AVX instructions
+//   < <= > >= == !=                   comparisons producing a Mask
+//   where(mask, a, b)                 a where mask is set, b elsewhere
+// A Mask can store itself as kSize bytes of 0 or 1.
+
+// Scalar fallback with one value per pack. Works with every arithmetic
+// type, and handles the elements that don't fill a complete SIMD pack.
+class ScalarMask
+{
+public:
+	explicit ScalarMask(bool value) : mValue(value) {}
+	void store(unsigned char* dest) const { *dest = mValue; }
+	bool get() const { return mValue; }
+
+private:
+	bool mValue;
+};
+
+template <typename T>
+class ScalarPack
+{
+public:
+	using value_type = T;
+	using Mask = ScalarMask;
+	static const size_t kSize = 1;
+
+	explicit ScalarPack(T value) : mValue(value) {}
+
+	static ScalarPack load(const T* source) { return ScalarPack(*source); }
+	static ScalarPack broadcast(T value) { return ScalarPack(value); }
+	void store(T* dest) const { *dest = mValue; }
+
+	friend ScalarPack operator+(ScalarPack a, ScalarPack b) { return ScalarPack(a.mValue + b.mValue); }
+	friend ScalarPack operator-(ScalarPack a, ScalarPack b) { return ScalarPack(a.mValue - b.mValue); }
+	friend ScalarPack operator*(ScalarPack a, ScalarPack b) { return ScalarPack(a.mValue * b.mValue); }
+	friend ScalarPack operator/(ScalarPack a, ScalarPack b) { return ScalarPack(a.mValue / b.mValue); }
+	friend ScalarPack fusedMultiplyAdd(ScalarPack a, ScalarPack b, ScalarPack c)
+	{
+		return ScalarPack(a.mValue * b.mValue + c.mValue);
+	}
+	// Not std::min and std::max, which return a if either value is NaN.
+	friend ScalarPack minimum(ScalarPack a, ScalarPack b) { return ScalarPack(a.mValue < b.mValue ? a.mValue : b.mValue); }
+	friend ScalarPack maximum(ScalarPack a, ScalarPack b) { return ScalarPack(a.mValue > b.mValue ? a.mValue : b.mValue); }
+
+	friend Mask operator<(ScalarPack a, ScalarPack b) { return Mask(a.mValue < b.mValue); }
+	friend Mask operator<=(ScalarPack a, ScalarPack b) { return Mask(a.mValue <= b.mValue); }
+	friend Mask operator>(ScalarPack a, ScalarPack b) { return Mask(a.mValue > b.mValue); }
+	friend Mask operator>=(ScalarPack a, ScalarPack b) { return Mask(a.mValue >= b.mValue); }
+	friend Mask operator==(ScalarPack a, ScalarPack b) { return Mask(a.mValue == b.mValue); }
+	friend Mask operator!=(ScalarPack a, ScalarPack b) { return Mask(a.mValue != b.mValue); }
+
+	friend ScalarPack where(Mask mask, ScalarPack a, ScalarPack b) { return mask.get() ? a : b; }
+
+private:
+	T mValue;
+};
+
+#if defined(__AVX2__) || defined(__SSE2__)
+
+// Pack built on the low-level operations in Ops, which wrap the
+// intrinsics of one instruction set for one element type.
+template <typename T, typename Ops>
+class SimdPack
+{
+public:
+	using value_type = T;
+	using Register = typename Ops::Register;
+	static const size_t kSize = Ops::kSize;
+
+	// Comparison results have all bits of a lane set or cleared.
+	class Mask
+	{
+	public:
+		explicit Mask(Register bits) : mBits(bits) {}
+		void store(unsigned char* dest) const
+		{
+			int bits = Ops::movemask(mBits);
+			for (size_t i = 0; i < kSize; ++i) {
+				dest[i] = (bits >> i) & 1;
+			}
+		}
+		Register get() const { return mBits; }
+
+	private:
+		Register mBits;
+	};
+
+	explicit SimdPack(Register value) : mValue(value) {}
+
+	static SimdPack load(const T* source) { return SimdPack(Ops::load(source)); }
+	static SimdPack broadcast(T value) { return SimdPack(Ops::set1(value)); }
+	void store(T* dest) const { Ops::store(dest, mValue); }
+
+	friend SimdPack operator+(SimdPack a, SimdPack b) { return SimdPack(Ops::add(a.mValue, b.mValue)); }
+	friend SimdPack operator-(SimdPack a, SimdPack b) { return SimdPack(Ops::sub(a.mValue, b.mValue)); }
+	friend SimdPack operator*(SimdPack a, SimdPack b) { return SimdPack(Ops::mul(a.mValue, b.mValue)); }
+	friend SimdPack operator/(SimdPack a, SimdPack b) { return SimdPack(Ops::div(a.mValue, b.mValue)); }
+	friend SimdPack fusedMultiplyAdd(SimdPack a, SimdPack b, SimdPack c)
+	{
+		return SimdPack(Ops::fmadd(a.mValue, b.mValue, c.mValue));
+	}
+	friend SimdPack minimum(SimdPack a, SimdPack b) { return SimdPack(Ops::min(a.mValue, b.mValue)); }
+	friend SimdPack maximum(SimdPack a, SimdPack b) { return SimdPack(Ops::max(a.mValue, b.mValue)); }
+
+	friend Mask operator<(SimdPack a, SimdPack b) { return Mask(Ops::lt(a.mValue, b.mValue)); }
+	friend Mask operator<=(SimdPack a, SimdPack b) { return Mask(Ops::le(a.mValue, b.mValue)); }
+	friend Mask operator>(SimdPack a, SimdPack b) { return Mask(Ops::lt(b.mValue, a.mValue)); }
+	friend Mask operator>=(SimdPack a, SimdPack b) { return Mask(Ops::le(b.mValue, a.mValue)); }
+	friend Mask operator==(SimdPack a, SimdPack b) { return Mask(Ops::eq(a.mValue, b.mValue)); }
+	friend Mask operator!=(SimdPack a, SimdPack b) { return Mask(Ops::neq(a.mValue, b.mValue)); }
+
+	friend SimdPack where(Mask mask, SimdPack a, SimdPack b)
+	{
+		return SimdPack(Ops::blend(mask.get(), a.mValue, b.mValue));
+	}
+
+private:
+	Register mValue;
+};
+
+#endif
+
+#if defined(__AVX2__)
+
+struct AvxDoubleOps
+{
+	using Register = __m256d;
+	static const size_t kSize = 4;
+	static Register load(const double* p) { return _mm256_loadu_pd(p); }
+	static void store(double* p, Register a) { _mm256_storeu_pd(p, a); }
+	static Register set1(double value) { return _mm256_set1_pd(value); }
+	static Register add(Register a, Register b) { return _mm256_add_pd(a, b); }
+	static Register sub(Register a, Register b) { return _mm256_sub_pd(a, b); }
+	static Register mul(Register a, Register b) { return _mm256_mul_pd(a, b); }
+	static Register div(Register a, Register b) { return _mm256_div_pd(a, b); }
+#if defined(__FMA__)
+	static Register fmadd(Register a, Register b, Register c) { return _mm256_fmadd_pd(a, b, c); }
+#else
+	static Register fmadd(Register a, Register b, Register c) { return add(mul(a, b), c); }
+#endif
+	static Register min(Register a, Register b) { return _mm256_min_pd(a, b); }
+	static Register max(Register a, Register b) { return _mm256_max_pd(a, b); }
+	static Register lt(Register a, Register b) { return _mm256_cmp_pd(a, b, _CMP_LT_OQ); }
+	static Register le(Register a, Register b) { return _mm256_cmp_pd(a, b, _CMP_LE_OQ); }
+	static Register eq(Register a, Register b) { return _mm256_cmp_pd(a, b, _CMP_EQ_OQ); }
+	static Register neq(Register a, Register b) { return _mm256_cmp_pd(a, b, _CMP_NEQ_UQ); }
+	static Register blend(Register mask, Register a, Register b) { return _mm256_blendv_pd(b, a, mask); }
+	static int movemask(Register mask) { return _mm256_movemask_pd(mask); }
+};
+
+struct AvxFloatOps
+{
+	using Register = __m256;
+	static const size_t kSize = 8;
+	static Register load(const float* p) { return _mm256_loadu_ps(p); }
+	static void store(float* p, Register a) { _mm256_storeu_ps(p, a); }
+	static Register set1(float value) { return _mm256_set1_ps(value); }
+	static Register add(Register a, Register b) { return _mm256_add_ps(a, b); }
+	static Register sub(Register a, Register b) { return _mm256_sub_ps(a, b); }
+	static Register mul(Register a, Register b) { return _mm256_mul_ps(a, b); }
+	static Register div(Register a, Register b) { return _mm256_div_ps(a, b); }
+#if defined(__FMA__)
+	static Register fmadd(Register a, Register b, Register c) { return _mm256_fmadd_ps(a, b, c); }
+#else
+	static Register fmadd(Register a, Register b, Register c) { return add(mul(a, b), c); }
+#endif
+	static Register min(Register a, Register b) { return _mm256_min_ps(a, b); }
+	static Register max(Register a, Register b) { return _mm256_max_ps(a, b); }
+	static Register lt(Register a, Register b) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+	static Register le(Register a, Register b) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+	static Register eq(Register a, Register b) { return _mm256_cmp_ps(a, b, _CMP_EQ_OQ); }
+	static Register neq(Register a, Register b) { return _mm256_cmp_ps(a, b, _CMP_NEQ_UQ); }
+	static Register blend(Register mask, Register a, Register b) { return _mm256_blendv_ps(b, a, mask); }
+	static int movemask(Register mask) { return _mm256_movemask_ps(mask); }
+};
+
+template <typename T> struct SimdPackFor { using type = ScalarPack<T>; };
+template <> struct SimdPackFor<double> { using type = SimdPack<double, AvxDoubleOps>; };
+template <> struct SimdPackFor<float> { using type = SimdPack<float, AvxFloatOps>; };
+
+#elif defined(__SSE2__)
+
+struct SseDoubleOps
+{
+	using Register = __m128d;
+	static const size_t kSize = 2;
+	static Register load(const double* p) { return _mm_loadu_pd(p); }
+	static void store(double* p, Register a) { _mm_storeu_pd(p, a); }
+	static Register set1(double value) { return _mm_set1_pd(value); }
+	static Register add(Register a, Register b) { return _mm_add_pd(a, b); }
+	static Register sub(Register a, Register b) { return _mm_sub_pd(a, b); }
+	static Register mul(Register a, Register b) { return _mm_mul_pd(a, b); }
+	static Register div(Register a, Register b) { return _mm_div_pd(a, b); }
+	static Register fmadd(Register a, Register b, Register c) { return add(mul(a, b), c); }
+	static Register min(Register a, Register b) { return _mm_min_pd(a, b); }
+	static Register max(Register a, Register b) { return _mm_max_pd(a, b); }
+	static Register lt(Register a, Register b) { return _mm_cmplt_pd(a, b); }
+	static Register le(Register a, Register b) { return _mm_cmple_pd(a, b); }
+	static Register eq(Register a, Register b) { return _mm_cmpeq_pd(a, b); }
+	static Register neq(Register a, Register b) { return _mm_cmpneq_pd(a, b); }
+	static Register blend(Register mask, Register a, Register b)
+	{
+		return _mm_or_pd(_mm_and_pd(mask, a), _mm_andnot_pd(mask, b));
+	}
+	static int movemask(Register mask) { return _mm_movemask_pd(mask); }
+};
+
+struct SseFloatOps
+{
+	using Register = __m128;
+	static const size_t kSize = 4;
+	static Register load(const float* p) { return _mm_loadu_ps(p); }
+	static void store(float* p, Register a) { _mm_storeu_ps(p, a); }
+	static Register set1(float value) { return _mm_set1_ps(value); }
+	static Register add(Register a, Register b) { return _mm_add_ps(a, b); }
+	static Register sub(Register a, Register b) { return _mm_sub_ps(a, b); }
+	static Register mul(Register a, Register b) { return _mm_mul_ps(a, b); }
+	static Register div(Register a, Register b) { return _mm_div_ps(a, b); }
+	static Register fmadd(Register a, Register b, Register c) { return add(mul(a, b), c); }
+	static Register min(Register a, Register b) { return _mm_min_ps(a, b); }
+	static Register max(Register a, Register b) { return _mm_max_ps(a, b); }
+	static Register lt(Register a, Register b) { return _mm_cmplt_ps(a, b); }
+	static Register le(Register a, Register b) { return _mm_cmple_ps(a, b); }
+	static Register eq(Register a, Register b) { return _mm_cmpeq_ps(a, b); }
+	static Register neq(Register a, Register b) { return _mm_cmpneq_ps(a, b); }
+	static Register blend(Register mask, Register a, Register b)
+	{
+		return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+	}
+	static int movemask(Register mask) { return _mm_movemask_ps(mask); }
+};
+
+template <typename T> struct SimdPackFor { using type = ScalarPack<T>; };
+template <> struct SimdPackFor<double> { using type = SimdPack<double, SseDoubleOps>; };
+template <> struct SimdPackFor<float> { using type = SimdPack<float, SseFloatOps>; };
+
+#else
+
+template <typename T> struct SimdPackFor { using type = ScalarPack<T>; };
+
+#endif
+
+// The widest pack available for T: an AVX2 or SSE2 pack for float and
+// double when the compiler targets those instruction sets, ScalarPack<T>
+// otherwise.
+template <typename T>
+using SimdPackFor_t = typename SimdPackFor<T>::type;